@@ -0,0 +1,285 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AdmissionControl.h"
+#include "Async/Async.h"
+#include "UE5Coro/Promise.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FAdmissionControl& FAdmissionControl::Get()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Coroutine admission control is only available on the GT"));
+	static FAdmissionControl Instance;
+	return Instance;
+}
+
+auto FAdmissionControl::Admit(FLatentPromise& Promise,
+                              std::shared_ptr<FPromiseExtras> Extras,
+                              const UObject* Target) -> EResult
+{
+	if (Scopes.Num() == 0) [[likely]] // Nothing is limited
+		return Admitted;
+
+	// Object limits take precedence over class limits
+	TObjectKey<UObject> Key(Target);
+	auto* Scope = Scopes.Find(Key);
+	if (!Scope)
+	{
+		Key = TObjectKey<UObject>(Target->GetClass());
+		Scope = Scopes.Find(Key);
+		if (!Scope)
+			return Admitted;
+	}
+
+	EResult Result = Admitted;
+	TArray<TCoroutine<>> Evicted;
+	if (Scope->Live.Num() >= Scope->MaxLive)
+	{
+		switch (Scope->Policy)
+		{
+			case EAdmissionPolicy::Queue:
+				Result = Queued;
+				break;
+
+			case EAdmissionPolicy::CancelOldest:
+				while (Scope->Live.Num() > 0 &&
+				       Scope->Live.Num() >= Scope->MaxLive)
+				{
+					Evicted.Add(Scope->Live.PopOldest());
+					++Scope->Counters.Evicted;
+				}
+				if (Scope->Live.Num() < Scope->MaxLive)
+					break;
+				[[fallthrough]]; // MaxLive is 0, there's no room to make
+
+			case EAdmissionPolicy::Reject:
+				++Scope->Counters.Rejected;
+				return Rejected;
+		}
+	}
+
+	TCoroutine<> Handle(Extras);
+	if (Result == Admitted)
+	{
+		Scope->Live.Add(Extras.get(), std::move(Handle));
+		++Scope->Counters.Admitted;
+	}
+	else
+		Scope->Queue.Add(Extras.get(), std::move(Handle));
+
+	{
+		UE::TUniqueLock Lock(Extras->Lock);
+		// Latent coroutines usually complete on the game thread, but they
+		// might run to completion on another thread
+		Promise.AddContinuation([Key, Ptr = Extras.get()](void*)
+		{
+			if (IsInGameThread())
+				Get().Release(Key, Ptr);
+			else
+				AsyncTask(ENamedThreads::GameThread,
+				          [Key, Ptr] { Get().Release(Key, Ptr); });
+		});
+	}
+
+	// Scope is not used after this point, this might end up calling Release
+	for (auto& Coro : Evicted)
+		Coro.Cancel();
+	return Result;
+}
+
+void FAdmissionControl::SetLimit(const UObject* Key, int32 MaxLive,
+                                 EAdmissionPolicy Policy)
+{
+	if (MaxLive < 0)
+	{
+		FScope Scope;
+		if (Scopes.RemoveAndCopyValue(Key, Scope))
+			while (Scope.Queue.Num() > 0)
+				Start(Scope.Queue.PopOldest());
+		return;
+	}
+
+	if (Scopes.Num() >= PruneThreshold && !Scopes.Contains(Key))
+		PruneAll();
+	auto& Scope = Scopes.FindOrAdd(Key);
+	Scope.MaxLive = MaxLive;
+	Scope.Policy = Policy;
+	StartQueued(Key); // The limit might have been raised
+}
+
+FAdmissionCounters FAdmissionControl::GetCounters(const UObject* Key) const
+{
+	auto* Scope = Scopes.Find(Key);
+	if (!Scope)
+		return {};
+
+	auto Counters = Scope->Counters;
+	Counters.Live = Scope->Live.Num();
+	Counters.Queued = Scope->Queue.Num();
+	return Counters;
+}
+
+void FAdmissionControl::Release(TObjectKey<UObject> Key, FPromiseExtras* Extras)
+{
+	auto* Scope = Scopes.Find(Key);
+	if (!Scope) // The limit was removed since this coroutine started
+		return;
+
+	// Entries hold a reference to Extras, so the address cannot be reused
+	// by another coroutine while it's still in these containers
+	if (Scope->Live.Remove(Extras))
+		StartQueued(Key);
+	else // Canceled while queued, or already evicted
+		Scope->Queue.Remove(Extras);
+	PruneIfStale(Key);
+}
+
+void FAdmissionControl::StartQueued(TObjectKey<UObject> Key)
+{
+	TArray<TCoroutine<>> Starting;
+	if (auto* Scope = Scopes.Find(Key))
+		while (Scope->Queue.Num() > 0 && Scope->Live.Num() < Scope->MaxLive)
+		{
+			auto& Handle = Starting.Add_GetRef(Scope->Queue.PopOldest());
+			Scope->Live.Add(Handle.Extras.get(), Handle);
+			++Scope->Counters.Admitted;
+		}
+
+	// Starting coroutines might reenter this object, bookkeeping is done
+	for (auto& Handle : Starting)
+		Start(Handle);
+}
+
+void FAdmissionControl::PruneIfStale(TObjectKey<UObject> Key)
+{
+	// Limits of destroyed owners cannot be removed by their users anymore
+	auto* Scope = Scopes.Find(Key);
+	if (Scope && Scope->Live.Num() == 0 && Scope->Queue.Num() == 0 &&
+	    !Key.ResolveObjectPtr())
+		Scopes.Remove(Key);
+}
+
+void FAdmissionControl::PruneAll()
+{
+	// Owners that died without a coroutine completing afterwards are only
+	// found by this sweep, it's amortized by doubling the threshold
+	for (auto It = Scopes.CreateIterator(); It; ++It)
+		if (It->Value.Live.Num() == 0 && It->Value.Queue.Num() == 0 &&
+		    !It->Key.ResolveObjectPtr())
+			It.RemoveCurrent();
+	PruneThreshold = FMath::Max(16, Scopes.Num() * 2);
+}
+
+void FAdmissionControl::Start(const TCoroutine<>& Handle)
+{
+	// Latent promises are only destroyed on the game thread, and Release
+	// removes them from the queue when that happens
+	auto* Promise = static_cast<FLatentPromise*>(Handle.Extras->Promise);
+	checkf(Promise, TEXT("Internal error: queued coroutine is gone"));
+	Promise->Resume(); // Processes cancellations that arrived while queued
+}
+
+void Latent::SetAdmissionLimit(const UObject* Owner, int32 MaxLive,
+                               EAdmissionPolicy Policy)
+{
+	// Owners that are being destroyed may still have their limit removed
+	if (ensureMsgf(MaxLive < 0 ? Owner != nullptr : IsValid(Owner),
+	               TEXT("Invalid admission control owner")))
+		FAdmissionControl::Get().SetLimit(Owner, MaxLive, Policy);
+}
+
+void Latent::SetClassAdmissionLimit(const UClass* Class, int32 MaxLive,
+                                    EAdmissionPolicy Policy)
+{
+	if (ensureMsgf(IsValid(Class), TEXT("Invalid admission control class")))
+		FAdmissionControl::Get().SetLimit(Class, MaxLive, Policy);
+}
+
+FAdmissionCounters Latent::GetAdmissionCounters(const UObject* Owner)
+{
+	return FAdmissionControl::Get().GetCounters(Owner);
+}
+
+FAdmissionCounters Latent::GetClassAdmissionCounters(const UClass* Class)
+{
+	return FAdmissionControl::Get().GetCounters(Class);
+}
+
+void FAdmissionControl::FFifo::Add(FPromiseExtras* Key, TCoroutine<> Handle)
+{
+	auto Sequence = NextSequence++;
+	Entries.Add(Key, FEntry{std::move(Handle), Sequence});
+	Order.Emplace(Key, Sequence);
+}
+
+bool FAdmissionControl::FFifo::Remove(FPromiseExtras* Key)
+{
+	if (Entries.Remove(Key) == 0)
+		return false;
+	// Bound the number of stale entries left in Order
+	if (Order.Num() - Head > 2 * Entries.Num() + 16)
+		Compact();
+	return true;
+}
+
+TCoroutine<> FAdmissionControl::FFifo::PopOldest()
+{
+	checkf(Num() > 0, TEXT("Internal error: popping empty admission FIFO"));
+	while (IsStale(Order[Head]))
+		++Head;
+	auto* Key = Order[Head++].Key;
+	auto Handle = Entries.FindChecked(Key).Handle;
+	Entries.Remove(Key);
+	if (Head > Order.Num() / 2) // Amortized O(1)
+		Compact();
+	return Handle;
+}
+
+bool FAdmissionControl::FFifo::IsStale(
+	const TPair<FPromiseExtras*, uint64>& Item) const
+{
+	// A new coroutine might have reused the address of a removed one
+	auto* Entry = Entries.Find(Item.Key);
+	return !Entry || Entry->Sequence != Item.Value;
+}
+
+void FAdmissionControl::FFifo::Compact()
+{
+	int32 Out = 0;
+	for (int32 i = Head; i < Order.Num(); ++i)
+		if (!IsStale(Order[i]))
+			Order[Out++] = Order[i];
+	Order.SetNum(Out);
+	Head = 0;
+}
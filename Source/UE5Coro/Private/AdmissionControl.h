@@ -0,0 +1,106 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include "UE5Coro/Coroutine.h"
+#include "UE5Coro/LatentAdmission.h"
+#include "UObject/ObjectKey.h"
+
+namespace UE5Coro::Private
+{
+/** Game thread-only bookkeeping for Latent::SetAdmissionLimit. */
+class FAdmissionControl final
+{
+	// FIFO of coroutines with O(1) removal by identity. Removed entries are
+	// left in Order, and skipped based on their sequence number.
+	class FFifo
+	{
+		struct FEntry
+		{
+			TCoroutine<> Handle;
+			uint64 Sequence;
+		};
+		TMap<FPromiseExtras*, FEntry> Entries;
+		TArray<TPair<FPromiseExtras*, uint64>> Order; // Oldest first
+		int32 Head = 0; // Order[0..Head) has been popped
+		uint64 NextSequence = 0;
+
+	public:
+		[[nodiscard]] int32 Num() const { return Entries.Num(); }
+		void Add(FPromiseExtras* Key, TCoroutine<> Handle);
+		bool Remove(FPromiseExtras* Key);
+		[[nodiscard]] TCoroutine<> PopOldest();
+
+	private:
+		[[nodiscard]] bool IsStale(const TPair<FPromiseExtras*, uint64>&) const;
+		void Compact();
+	};
+
+	struct FScope
+	{
+		int32 MaxLive = -1;
+		EAdmissionPolicy Policy = EAdmissionPolicy::Queue;
+		FFifo Live;
+		FFifo Queue;
+		FAdmissionCounters Counters;
+	};
+
+	// Keyed by both objects and classes
+	TMap<TObjectKey<UObject>, FScope> Scopes;
+	// Scopes of destroyed owners are swept when this many scopes exist
+	int32 PruneThreshold = 16;
+
+public:
+	enum EResult
+	{
+		Admitted,
+		Queued,
+		Rejected,
+	};
+
+	static FAdmissionControl& Get();
+
+	EResult Admit(FLatentPromise&, std::shared_ptr<FPromiseExtras>,
+	              const UObject* Target);
+	void SetLimit(const UObject* Key, int32 MaxLive, EAdmissionPolicy);
+	FAdmissionCounters GetCounters(const UObject* Key) const;
+
+private:
+	void Release(TObjectKey<UObject> Key, FPromiseExtras* Extras);
+	void StartQueued(TObjectKey<UObject> Key);
+	void PruneIfStale(TObjectKey<UObject> Key);
+	void PruneAll();
+	static void Start(const TCoroutine<>&);
+};
+}
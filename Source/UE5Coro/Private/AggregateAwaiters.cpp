@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/AggregateAwaiter.h"
+#include "TimerThread.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
@@ -39,9 +40,9 @@ void FAggregateAwaiter::Cancel(void* This, FPromise& Promise)
 	auto* Awaiter = static_cast<FAggregateAwaiter*>(This);
 	if (Promise.UnregisterCancelableAwaiter<false>())
 	{
+		auto* Data = Awaiter->Data.get();
 		TArray<TCoroutine<>> Handles;
 		{
-			auto* Data = Awaiter->Data.get();
 			UE::TUniqueLock Lock(Data->Lock);
 			verifyf(!std::exchange(Data->bCanceled, true),
 			        TEXT("Internal error: double cancellation"));
@@ -49,12 +50,158 @@ void FAggregateAwaiter::Cancel(void* This, FPromise& Promise)
 			        TEXT("Internal error: expected active awaiter"));
 			Handles = std::move(Data->Handles);
 		}
+		// Waits that are already ending will see bCanceled instead.
+		// Awaiter keeps Data alive until it's resumed below.
+		for (auto& Wait : Data->Waits)
+			if (TryUnregister(Wait))
+				Wait.Data = nullptr;
 		FAsyncYieldAwaiter::Suspend(Promise);
 		for (auto& Coro : Handles) // Cancel all inner coroutines
 			Coro.Cancel();
 	}
 }
 
+FPromise* FAggregateAwaiter::Arrive(FData& Data, int Index)
+{
+	UE::TDynamicUniqueLock Lock(Data.Lock);
+	if (--Data.Count != 0)
+		return nullptr;
+	Data.Index = Index; // Mark that this index was the one reaching 0
+	auto* Promise = Data.Promise;
+	Lock.Unlock();
+
+	// Not co_awaited yet if Promise is nullptr, await_ready deals with this
+	if (Promise != nullptr && Promise->UnregisterCancelableAwaiter<true>())
+		return Promise;
+	return nullptr;
+}
+
+void FAggregateAwaiter::OnCoroutineCompleted(FContinuationNode* Node, void*)
+{
+	auto* Continuation = static_cast<FContinuation*>(Node);
+	// The node lives in Data, keep it alive until this function returns
+	auto Data = std::move(Continuation->Data);
+	if (auto* Promise = Arrive(*Data, Continuation->Index))
+		Promise->Resume();
+}
+
+bool FAggregateAwaiter::OnWaitResumed(FWaitNode& Node, bool bDispatch)
+{
+	auto& Wait = static_cast<FWait&>(Node);
+	// The node lives in Data, keep it alive until this function returns
+	auto Data = std::move(Wait.Data);
+	{
+		UE::TUniqueLock Lock(Data->Lock);
+		if (Data->bCanceled) // Let the event or semaphore resume someone else
+			return false;
+	}
+	if (auto* Promise = Arrive(*Data, Wait.Index))
+	{
+		if (bDispatch)
+			FAsyncAwaiter(ENamedThreads::AnyThread).Suspend(*Promise);
+		else
+			Promise->Resume();
+	}
+	return true;
+}
+
+void FAggregateAwaiter::OnTimerExpired(FAsyncTimeAwaiter& Timer)
+{
+	// This runs on the timer thread, resume where co_await Timer would have
+	auto& Wait = *static_cast<FTimer&>(Timer).Wait;
+	auto Thread = Timer.Thread;
+	// The node lives in Data, keep it alive until this function returns
+	auto Data = std::move(Wait.Data);
+	if (auto* Promise = Arrive(*Data, Wait.Index))
+		FAsyncAwaiter(Thread).Suspend(*Promise);
+}
+
+bool FAggregateAwaiter::TryUnregister(FWait& Wait)
+{
+	if (auto* Event = Wait.Event)
+	{
+		UE::TUniqueLock Lock(Event->Lock);
+		return Event->Waiters.Remove(Wait);
+	}
+	if (auto* Semaphore = Wait.Semaphore)
+	{
+		UE::TUniqueLock Lock(Semaphore->Lock);
+		return Semaphore->Waiters.Remove(Wait);
+	}
+	return Wait.Timer && FTimerThread::Get().TryUnregister(&*Wait.Timer);
+}
+
+void FAggregateAwaiter::Continue(const TCoroutine<>& Coroutine, int Index,
+                                 int Slot)
+{
+	auto& Continuation = Data->Continuations[Slot];
+	Continuation.Fn = &OnCoroutineCompleted;
+	Continuation.Data = Data;
+	Continuation.Index = Index;
+	if (!Coroutine.Extras->TryAddContinuation(Continuation))
+	{
+		Continuation.Data = nullptr; // Already complete, not a cycle
+		Arrive(*Data, Index); // Not co_awaited yet, there's nothing to resume
+	}
+}
+
+void FAggregateAwaiter::Register(FAwaitableEvent& Event, int Index, int Slot)
+{
+	auto& Wait = Data->Waits[Slot];
+	Wait.Callback = &OnWaitResumed;
+	Wait.Index = Index;
+	Wait.Event = &Event;
+	// await_ready leaves the event locked if it returns false
+	if (FEventAwaiter(Event).await_ready())
+		Arrive(*Data, Index);
+	else
+	{
+		Wait.Data = Data;
+		Event.Waiters.PushBack(Wait);
+		Event.Lock.Unlock();
+	}
+}
+
+void FAggregateAwaiter::Register(FAwaitableSemaphore& Semaphore, int Index,
+                                 int Slot)
+{
+	auto& Wait = Data->Waits[Slot];
+	Wait.Callback = &OnWaitResumed;
+	Wait.Index = Index;
+	Wait.Semaphore = &Semaphore;
+	// await_ready leaves the semaphore locked if it returns false
+	if (FSemaphoreAwaiter(Semaphore).await_ready())
+		Arrive(*Data, Index);
+	else
+	{
+		Wait.Data = Data;
+		Semaphore.Waiters.PushBack(Wait);
+		Semaphore.Lock.Unlock();
+	}
+}
+
+void FAggregateAwaiter::Register(const FAsyncTimeAwaiter& Awaiter, int Index,
+                                 int Slot)
+{
+	auto& Wait = Data->Waits[Slot];
+	Wait.Timer.Emplace(Awaiter, &Wait);
+	FAsyncTimeAwaiter& Timer = *Wait.Timer;
+	Wait.Index = Index;
+	if (Timer.await_ready())
+	{
+		Arrive(*Data, Index);
+		return;
+	}
+	// Match FAsyncTimeAwaiter::Suspend, as if it were co_awaited right now
+	if (Timer.bAnyThread)
+		Timer.Thread = ENamedThreads::AnyThread;
+	else
+		Timer.Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	Timer.OnExpired = &OnTimerExpired;
+	Wait.Data = Data;
+	FTimerThread::Get().Register(&Timer);
+}
+
 int FAggregateAwaiter::GetResumerIndex() const
 {
 	checkf(Data->Count <= 0, TEXT("Internal error: resuming too early"));
@@ -70,8 +217,9 @@ FAggregateAwaiter::FAggregateAwaiter(auto All,
 	  Data(std::make_shared<FData>(All.value ? Coroutines.Num()
 	                                         : Coroutines.Num() ? 1 : 0))
 {
+	Data->Continuations.SetNum(Coroutines.Num());
 	for (int i = 0; i < Coroutines.Num(); ++i)
-		Data->Handles.Add(Consume(Data, i, Coroutines[i]));
+		Continue(Coroutines[i], i, i);
 }
 template UE5CORO_API FAggregateAwaiter::FAggregateAwaiter(
 	std::false_type, const TArray<TCoroutine<>>&);
@@ -150,26 +298,32 @@ FRaceAwaiter::FRaceAwaiter(TArray<TCoroutine<>>&& Array)
 			if (Data->Index != -1 || Data->bCanceled)
 				return;
 			Data->Index = i;
+			auto* Promise = Data->Promise;
+			// Handles is not modified after construction. Canceling the others
+			// might synchronously run their continuations, which take the lock.
+			Lock.Unlock();
+			bool bResume = Promise && Promise->UnregisterCancelableAwaiter<true>();
 
 			for (int j = 0; j < Data->Handles.Num(); ++j)
 				if (j != i) // Cancel the others
 					Data->Handles[j].Cancel();
 
-			if (auto* Promise = Data->Promise)
-			{
-				Lock.Unlock();
-				if (Promise->UnregisterCancelableAwaiter<true>())
-					Promise->Resume();
-			}
+			if (bResume)
+				Promise->Resume();
 		});
 	}
 }
 
 FRaceAwaiter::~FRaceAwaiter()
 {
-	UE::TUniqueLock Lock(Data->Lock);
-	Data->bCanceled = true;
-	if (Data->Index == -1)
+	bool bCancel;
+	{
+		UE::TUniqueLock Lock(Data->Lock);
+		Data->bCanceled = true;
+		bCancel = Data->Index == -1;
+	}
+	// Cancellations might complete synchronously and take the lock
+	if (bCancel)
 		for (auto& Handle : Data->Handles)
 			Handle.Cancel();
 }
@@ -227,6 +381,276 @@ int FRaceAwaiter::await_resume() noexcept
 	return Data->Index;
 }
 
+struct FAllResultsAwaiter::FState
+{
+	UE::FMutex Lock;
+	std::atomic<int> RefCount; // One per continuation, and one for the awaiter
+	int Remaining;
+	bool bAttaching = true; // Suspend is still using the awaiter
+	bool bCanceled = false;
+	FPromise* Promise;
+
+	explicit FState(int Num, FPromise* Promise)
+		: RefCount(Num + 1), Remaining(Num), Promise(Promise) { }
+
+	void Release()
+	{
+		if (--RefCount == 0)
+			delete this;
+	}
+};
+
+FAllResultsAwaiter::FAllResultsAwaiter()
+	: TCancelableAwaiter(&Cancel)
+{
+}
+
+FAllResultsAwaiter::FAllResultsAwaiter(FAllResultsAwaiter&& Other) noexcept
+	: TCancelableAwaiter(&Cancel)
+{
+	checkf(!Other.State, TEXT("Attempting to move awaiter after co_await"));
+}
+
+FAllResultsAwaiter::~FAllResultsAwaiter()
+{
+	if (State)
+		State->Release();
+}
+
+bool FAllResultsAwaiter::Ready(TCoroutine<>* Coroutines, int Num)
+{
+	checkf(!State, TEXT("Attempting to reuse awaiter"));
+	Awaited = Coroutines;
+	NumAwaited = Num;
+	for (int i = 0; i < Num; ++i)
+		if (!Coroutines[i].IsDone())
+			return false;
+	return true;
+}
+
+void FAllResultsAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(!State, TEXT("Attempting to reuse awaiter"));
+	{
+		UE::TUniqueLock Lock(Promise.GetLock());
+		if (!Promise.RegisterCancelableAwaiter(this))
+		{
+			FAsyncYieldAwaiter::Suspend(Promise);
+			return;
+		}
+		State = new FState(NumAwaited, &Promise);
+	}
+
+	// Coroutines that have completed since await_ready run this synchronously,
+	// which cannot happen with the promise lock held
+	for (int i = 0; i < NumAwaited; ++i)
+		Awaited[i].ContinueWith([State = State] { Arrive(State); });
+
+	UE::TDynamicUniqueLock Lock(State->Lock);
+	State->bAttaching = false;
+	if (State->bCanceled) // Cancel left resuming to this thread
+	{
+		Lock.Unlock();
+		FAsyncYieldAwaiter::Suspend(Promise);
+	}
+	else if (State->Remaining == 0) // Everything completed while attaching
+	{
+		Lock.Unlock();
+		if (Promise.UnregisterCancelableAwaiter<true>())
+			Promise.Resume();
+	}
+}
+
+void FAllResultsAwaiter::Arrive(FState* State)
+{
+	UE::TDynamicUniqueLock Lock(State->Lock);
+	bool bResume = --State->Remaining == 0 && !State->bAttaching &&
+	               !State->bCanceled;
+	Lock.Unlock();
+
+	// If Cancel wins, it resumes the promise on another task like
+	// FAsyncCoroutineAwaiter, instead of destroying it synchronously
+	if (bResume && State->Promise->UnregisterCancelableAwaiter<true>())
+		State->Promise->Resume();
+	State->Release();
+}
+
+void FAllResultsAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	auto* Awaiter = static_cast<FAllResultsAwaiter*>(This);
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		UE::TDynamicUniqueLock Lock(Awaiter->State->Lock);
+		verifyf(!std::exchange(Awaiter->State->bCanceled, true),
+		        TEXT("Internal error: unexpected double cancellation"));
+		// The awaiter is in use until Suspend returns, which will resume
+		if (!Awaiter->State->bAttaching)
+		{
+			Lock.Unlock();
+			FAsyncYieldAwaiter::Suspend(Promise);
+		}
+	}
+}
+
+FForEachConcurrentState::FForEachConcurrentState(int MaxInFlight)
+	: MaxInFlight(MaxInFlight)
+{
+	checkf(MaxInFlight > 0, TEXT("MaxInFlight must be positive"));
+	Slots.SetNum(MaxInFlight);
+	FreeSlots.Reserve(MaxInFlight);
+	for (int i = MaxInFlight - 1; i >= 0; --i)
+		FreeSlots.Add(i);
+}
+
+void FForEachConcurrentState::Pump(
+	const std::shared_ptr<FForEachConcurrentState>& This)
+{
+	UE::TDynamicUniqueLock Lock(This->Lock);
+	if (This->bPumping) // The other thread will see any changes made so far
+		return;
+	This->bPumping = true;
+
+	while (!This->bCanceled && !This->bExhausted &&
+	       This->NumInFlight < This->MaxInFlight)
+	{
+		// Fn is user code, it might complete synchronously or take locks
+		Lock.Unlock();
+		auto Coro = This->StartNext();
+		Lock.Lock();
+		if (!Coro)
+		{
+			This->bExhausted = true;
+			break;
+		}
+
+		int Index = This->NextIndex++;
+		int Slot = This->FreeSlots.Pop();
+		++This->NumInFlight;
+		This->Slots[Slot] = *Coro;
+		bool bCanceled = This->bCanceled; // Stop might have missed this one
+		Lock.Unlock();
+
+		if (bCanceled)
+			Coro->Cancel();
+		// This might run synchronously, in which case Complete's Pump returns
+		// immediately and this loop picks up the freed slot
+		Coro->ContinueWith([This, Slot, Index]
+		{
+			Complete(This, Slot, Index);
+		});
+		Lock.Lock();
+	}
+	This->bPumping = false;
+
+	if (This->NumInFlight > 0 || (!This->bExhausted && !This->bCanceled) ||
+	    This->bFinished)
+		return;
+	This->bFinished = true;
+	This->Failures.Sort(); // Completions might have come in any order
+	auto* Promise = This->Promise;
+	bool bCanceled = This->bCanceled;
+	Lock.Unlock();
+
+	if (!Promise) // Finished before suspending, await_ready will see this
+		return;
+	if (bCanceled) // Stop took responsibility for resuming
+		FAsyncYieldAwaiter::Suspend(*Promise);
+	else if (Promise->UnregisterCancelableAwaiter<true>())
+		Promise->Resume();
+	// Otherwise, Cancel is running and it will see bFinished in Stop
+}
+
+void FForEachConcurrentState::Complete(
+	const std::shared_ptr<FForEachConcurrentState>& This, int Slot, int Index)
+{
+	{
+		UE::TUniqueLock Lock(This->Lock);
+		auto& Coro = This->Slots[Slot];
+		checkf(Coro.IsSet(), TEXT("Internal error: completing empty slot"));
+		if (!Coro->WasSuccessful())
+			This->Failures.Add(Index);
+		Coro.Reset();
+		This->FreeSlots.Push(Slot);
+		--This->NumInFlight;
+	}
+	Pump(This);
+}
+
+bool FForEachConcurrentState::Stop(
+	const std::shared_ptr<FForEachConcurrentState>& This)
+{
+	checkf(This->Lock.IsLocked(), TEXT("Internal error: lock not held"));
+	if (This->bFinished) // Already done, the caller needs to resume
+	{
+		This->Lock.Unlock();
+		return false;
+	}
+	verifyf(!std::exchange(This->bCanceled, true),
+	        TEXT("Internal error: unexpected double cancellation"));
+	TArray<TCoroutine<>, TInlineAllocator<16>> Handles;
+	for (auto& Slot : This->Slots)
+		if (Slot)
+			Handles.Add(*Slot);
+	This->Lock.Unlock();
+
+	// Cancellations might complete synchronously and take the lock
+	for (auto& Handle : Handles)
+		Handle.Cancel();
+	Pump(This); // Finish if nothing was running
+	return true;
+}
+
+FForEachConcurrentAwaiter::FForEachConcurrentAwaiter(
+	std::shared_ptr<FForEachConcurrentState> State)
+	: TCancelableAwaiter(&Cancel), State(std::move(State)) { }
+
+void FForEachConcurrentAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	auto* Awaiter = static_cast<FForEachConcurrentAwaiter*>(This);
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		Awaiter->State->Lock.Lock();
+		if (!FForEachConcurrentState::Stop(Awaiter->State))
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
+bool FForEachConcurrentAwaiter::await_ready()
+{
+	checkf(State, TEXT("Attempting to await moved-from awaiter"));
+	FForEachConcurrentState::Pump(State); // Start the first MaxInFlight items
+
+	State->Lock.Lock();
+	if (State->bFinished)
+	{
+		State->Lock.Unlock();
+		return true;
+	}
+	checkf(!State->Promise, TEXT("Attempting to reuse awaiter"));
+	checkf(!State->bCanceled, TEXT("Attempting to reuse canceled awaiter"));
+	return false; // Passing the lock to Suspend
+}
+
+void FForEachConcurrentAwaiter::Suspend(FPromise& Promise)
+{
+	// Expecting a lock from await_ready
+	checkf(State->Lock.IsLocked(), TEXT("Internal error: lock not held"));
+
+	UE::TUniqueLock Lock(Promise.GetLock());
+	State->Promise = &Promise;
+	if (Promise.RegisterCancelableAwaiter(this))
+		State->Lock.Unlock();
+	else if (!FForEachConcurrentState::Stop(State)) // This unlocks
+		FAsyncYieldAwaiter::Suspend(Promise);
+}
+
+TArray<int> FForEachConcurrentAwaiter::await_resume()
+{
+	// Every coroutine has completed, nothing else will write this
+	checkf(State->bFinished, TEXT("Internal error: resuming too early"));
+	return State->Failures;
+}
+
 bool FLatentAggregate::ShouldResume(void* State, bool bCleanup)
 {
 	auto* This = static_cast<FLatentAggregate*>(State);
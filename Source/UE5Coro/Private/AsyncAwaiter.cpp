@@ -30,6 +30,8 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/AsyncAwaiter.h"
+#include "FrameTicker.h"
+#include "GameThreadInbox.h"
 #include "TimerThread.h"
 
 using namespace UE5Coro::Private;
@@ -67,6 +69,16 @@ public:
 		return ESubsequentsMode::FireAndForget;
 	}
 };
+
+void ResumeOn(ENamedThreads::Type Thread, FPromise& Promise)
+{
+	// Game thread resumes are batched instead of getting one task each
+	if (Thread == ENamedThreads::GameThread)
+		FGameThreadInbox::Get().Resume(Promise);
+	else
+		TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(
+			Thread, Promise);
+}
 }
 
 bool FAsyncAwaiter::await_ready()
@@ -78,17 +90,13 @@ bool FAsyncAwaiter::await_ready()
 
 void FAsyncAwaiter::Suspend(FPromise& Promise)
 {
-	TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(Thread,
-	                                                                    Promise);
+	ResumeOn(Thread, Promise);
 }
 
 FAsyncTimeAwaiter::FAsyncTimeAwaiter(const FAsyncTimeAwaiter& Other)
 	: TCancelableAwaiter(&Cancel), TargetTime(Other.TargetTime),
 	  Thread(Other.Thread) // bAnyThread included
 {
-	// Such a copy would need to happen after the coroutine was canceled
-	ensureMsgf(TargetTime != std::numeric_limits<double>::lowest(),
-	           TEXT("Copying a canceled awaiter copies the cancellation, too"));
 }
 
 FAsyncTimeAwaiter::~FAsyncTimeAwaiter()
@@ -110,10 +118,13 @@ void FAsyncTimeAwaiter::Suspend(FPromise& InPromise)
 	else
 		Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
 	UE::TUniqueLock Lock(InPromise.GetLock());
-	Promise = &InPromise;
-	if (!InPromise.RegisterCancelableAwaiter(this))
-		TargetTime = std::numeric_limits<double>::lowest(); // Expire ASAP
-	FTimerThread::Get().Register(this);
+	if (InPromise.RegisterCancelableAwaiter(this))
+	{
+		Promise = &InPromise;
+		FTimerThread::Get().Register(this);
+	}
+	else // Already canceled, skip the timer thread entirely
+		ResumeOn(Thread, InPromise);
 }
 
 void FAsyncTimeAwaiter::Cancel(void* This, FPromise& Promise)
@@ -126,28 +137,51 @@ void FAsyncTimeAwaiter::Cancel(void* This, FPromise& Promise)
 		{
 			verifyf(Awaiter->Promise.exchange(nullptr) == &Promise,
 			        TEXT("Internal error: mismatched promise at cancellation"));
-			TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(
-				Awaiter->Thread, Promise);
+			ResumeOn(Awaiter->Thread, Promise);
 		}
 		else
 			check(!"Internal error: unexpected race condition");
 	}
 }
 
-void FAsyncTimeAwaiter::Resume()
+void FAsyncTimeAwaiter::Resume(FPromise& InPromise, ENamedThreads::Type InThread)
 {
-	// This is called from the timer thread, coroutine resumption must be async
-	checkf(Promise, TEXT("Internal error: spurious resume without suspension"));
-	if (auto& P = *Promise.exchange(nullptr);
-	    P.UnregisterCancelableAwaiter<true>())
-		TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(
-			Thread, P);
+	// This is called from the timer thread without holding its lock, after the
+	// awaiter was unlinked. A concurrent Cancel will have no effect.
+	if (InPromise.UnregisterCancelableAwaiter<true>())
+		ResumeOn(InThread, InPromise);
 	else
 		check(!"Internal error: unexpected race condition");
 }
 
+#if UE5CORO_DEBUG
+FAsyncFrameAwaiter::~FAsyncFrameAwaiter()
+{
+	checkf(!Promise, TEXT("Internal error: destroying registered awaiter"));
+}
+#endif
+
+void FAsyncFrameAwaiter::Suspend(FPromise& InPromise)
+{
+	UE::TUniqueLock Lock(InPromise.GetLock());
+	if (InPromise.RegisterCancelableAwaiter(this))
+		FFrameTicker::Get().Register(this, InPromise);
+	else
+		FAsyncYieldAwaiter::Suspend(InPromise);
+}
+
+void FAsyncFrameAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	// Synchronize with the ticker first, promise second
+	if (FFrameTicker::Get().TryUnregister(static_cast<FAsyncFrameAwaiter*>(This)))
+	{
+		verifyf(Promise.UnregisterCancelableAwaiter<false>(),
+		        TEXT("Internal error: unexpected race condition"));
+		FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
 void FAsyncYieldAwaiter::Suspend(FPromise& Promise)
 {
-	TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(
-		FTaskGraphInterface::Get().GetCurrentThreadIfKnown(), Promise);
+	ResumeOn(FTaskGraphInterface::Get().GetCurrentThreadIfKnown(), Promise);
 }
@@ -30,6 +30,8 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/AsyncAwaiter.h"
+#include "BlockingPool.h"
+#include "UE5Coro/CoroutineExecutor.h"
 #include "UE5Coro/TaskAwaiter.h"
 #include "UE5CoroDelegateCallbackTarget.h"
 
@@ -97,9 +99,11 @@ FAsyncAwaiter Async::MoveToSimilarThread()
 	return FAsyncAwaiter(FTaskGraphInterface::Get().GetCurrentThreadIfKnown());
 }
 
-FTaskAwaiter Async::MoveToTask(const TCHAR* DebugName)
+FTaskAwaiter Async::MoveToTask(const TCHAR* DebugName,
+                               UE::Tasks::ETaskPriority Priority,
+                               UE::Tasks::EExtendedTaskPriority ExtendedPriority)
 {
-	return FTaskAwaiter(DebugName);
+	return FTaskAwaiter(DebugName, Priority, ExtendedPriority);
 }
 
 FThreadPoolAwaiter Async::MoveToThreadPool(FQueuedThreadPool& ThreadPool,
@@ -108,6 +112,11 @@ FThreadPoolAwaiter Async::MoveToThreadPool(FQueuedThreadPool& ThreadPool,
 	return FThreadPoolAwaiter(ThreadPool, Priority);
 }
 
+FExecutorAwaiter Async::MoveToExecutor(FCoroutineExecutor& Executor) noexcept
+{
+	return FExecutorAwaiter(Executor);
+}
+
 FAsyncYieldAwaiter Async::Yield() noexcept
 {
 	return {};
@@ -120,6 +129,23 @@ FNewThreadAwaiter Async::MoveToNewThread(EThreadPriority Priority,
 	return FNewThreadAwaiter(Priority, Affinity, Flags);
 }
 
+FBlockingPoolAwaiter Async::MoveToBlockingPool(EThreadPriority Priority,
+                                               uint64 Affinity) noexcept
+{
+	return FBlockingPoolAwaiter(Priority, Affinity);
+}
+
+FAsyncFrameAwaiter Async::NextFrame() noexcept
+{
+	return FAsyncFrameAwaiter(1);
+}
+
+FAsyncFrameAwaiter Async::Frames(int64 Frames) noexcept
+{
+	ensureMsgf(Frames >= 0, TEXT("Invalid number of frames %lld"), Frames);
+	return FAsyncFrameAwaiter(Frames);
+}
+
 FAsyncTimeAwaiter Async::PlatformSeconds(double Seconds) noexcept
 {
 	return FAsyncTimeAwaiter(FPlatformTime::Seconds() + Seconds, false);
@@ -169,6 +195,11 @@ void FThreadPoolAwaiter::Suspend(FPromise& InPromise)
 	Pool.AddQueuedWork(this, Priority);
 }
 
+void FBlockingPoolAwaiter::Suspend(FPromise& Promise)
+{
+	FBlockingPool::Get().Schedule(Promise, Priority, Affinity);
+}
+
 void FNewThreadAwaiter::Suspend(FPromise& Promise)
 {
 	new FAutoStartResumeRunnable(Promise, Priority, Affinity, Flags);
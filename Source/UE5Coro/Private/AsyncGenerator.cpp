@@ -0,0 +1,250 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/AsyncGenerator.h"
+#include "UE5Coro/AsyncAwaiter.h"
+
+using namespace UE5Coro::Private;
+
+FAsyncGeneratorState::~FAsyncGeneratorState()
+{
+#if UE5CORO_DEBUG
+	UE::TUniqueLock L(Lock);
+	checkf(Consumers.IsEmpty(),
+	       TEXT("Async generator destroyed with active awaiters"));
+#endif
+}
+
+void FAsyncGeneratorState::SetReadAhead(int Count)
+{
+	checkf(Count >= 0, TEXT("Invalid read-ahead"));
+	Lock.Lock();
+	ReadAhead = Count;
+	// Values that are already buffered are kept when the read-ahead shrinks
+	if (int NewCapacity = FMath::Max(Count + 1, Num); NewCapacity != Capacity)
+	{
+		Resize(NewCapacity);
+		Capacity = NewCapacity;
+		Head = 0;
+	}
+	auto* Promise = Num < ReadAhead ? std::exchange(Producer, nullptr) : nullptr;
+	Lock.Unlock();
+	if (Promise)
+		WakeProducer(*Promise);
+}
+
+void FAsyncGeneratorState::Finish()
+{
+	Lock.Lock();
+	checkf(!bDone && !Producer,
+	       TEXT("Internal error: unexpected generator completion"));
+	bDone = true;
+	auto* Nodes = Consumers.TakeAll();
+	Lock.Unlock();
+
+	// These receive empty results
+	while (auto* Node = Nodes)
+	{
+		Nodes = Node->Next; // Node might be gone after Resume()
+		auto& Promise = *Node->Promise;
+		if (Promise.UnregisterCancelableAwaiter<true>())
+			Promise.Resume();
+		else // Cancel() ran, but it found the node already gone
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
+bool FAsyncGeneratorState::TryYield(FPromise& Promise, void* Item,
+                                    FAsyncGeneratorWaitNode*& Consumer)
+{
+	Lock.Lock();
+	// A waiting consumer takes the value directly. It needs to be committed
+	// before that to not lose the value to a concurrent cancellation, which
+	// cannot be done while Lock is held.
+	while (Item)
+	{
+		auto* Node = static_cast<FAsyncGeneratorWaitNode*>(Consumers.PopFront());
+		if (!Node)
+		{
+			checkf(Num < Capacity, TEXT("Internal error: generator overflow"));
+			Store((Head + Num++) % Capacity, Item);
+			break;
+		}
+		Lock.Unlock();
+		auto& NodePromise = *Node->Promise;
+		if (NodePromise.UnregisterCancelableAwaiter<true>())
+		{
+			// Nothing else can access the node now, it will be resumed by the
+			// caller after the producer is done with Lock
+			Transfer(Item, Node->Item);
+			Consumer = Node;
+			Lock.Lock();
+			break;
+		}
+		// Cancel() ran, but it found the node already gone
+		FAsyncYieldAwaiter::Suspend(NodePromise);
+		Lock.Lock();
+	}
+
+	// Keep running if there's more demand, unless the generator was dropped
+	if ((!Consumers.IsEmpty() || Num < ReadAhead) &&
+	    !Promise.ShouldCancel(false))
+	{
+		Lock.Unlock();
+		return true;
+	}
+	return false; // Leave it locked
+}
+
+void FAsyncGeneratorState::WakeProducer(FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<true>())
+		Promise.Resume();
+	else // Cancel() ran, but it found the producer already gone
+		FAsyncYieldAwaiter::Suspend(Promise);
+}
+
+FAsyncGeneratorNextAwaiter::FAsyncGeneratorNextAwaiter(
+	FAsyncGeneratorState& State, void* Item)
+	: TCancelableAwaiter(&Cancel), State(State)
+{
+	Node.Item = Item;
+}
+
+bool FAsyncGeneratorNextAwaiter::await_ready()
+{
+	for (;;)
+	{
+		State.Lock.Lock();
+		if (State.Num > 0)
+		{
+			State.Load(State.Head, Node.Item);
+			State.Head = (State.Head + 1) % State.Capacity;
+			--State.Num;
+			// Let the producer refill the read-ahead buffer
+			auto* Producer = State.Num < State.ReadAhead
+				? std::exchange(State.Producer, nullptr) : nullptr;
+			State.Lock.Unlock();
+			if (Producer)
+				FAsyncGeneratorState::WakeProducer(*Producer);
+			return true;
+		}
+		if (State.bDone)
+		{
+			State.Lock.Unlock();
+			return true; // Empty result
+		}
+
+		// Run a parked producer on this thread. If it yields synchronously,
+		// the value will be in the buffer, and there's no need to suspend.
+		auto* Producer = std::exchange(State.Producer, nullptr);
+		if (!Producer)
+			return false; // It's running, leave it locked
+		State.Lock.Unlock();
+		FAsyncGeneratorState::WakeProducer(*Producer);
+	}
+}
+
+void FAsyncGeneratorNextAwaiter::Suspend(FPromise& Promise)
+{
+	{
+		UE::TUniqueLock L(Promise.GetLock());
+		checkf(State.Lock.IsLocked(),
+		       TEXT("Internal error: unguarded suspension"));
+		if (Promise.RegisterCancelableAwaiter(this))
+		{
+			Node.Promise = &Promise;
+			State.Consumers.PushBack(Node);
+		}
+		else
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+	State.Lock.Unlock();
+}
+
+void FAsyncGeneratorNextAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FAsyncGeneratorNextAwaiter*>(This);
+		UE::TUniqueLock L(Awaiter->State.Lock);
+		// If the node is not queued, a value is already on its way to it, and
+		// the producer will finish the cancellation
+		if (Awaiter->State.Consumers.Remove(Awaiter->Node))
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
+FAsyncGeneratorYieldAwaiter::FAsyncGeneratorYieldAwaiter(
+	FAsyncGeneratorState& State, FPromise& Promise, void* Item)
+	: TCancelableAwaiter(&Cancel), State(State), Promise(Promise), Item(Item)
+{
+}
+
+bool FAsyncGeneratorYieldAwaiter::await_ready()
+{
+	if (!State.TryYield(Promise, Item, Consumer))
+		return false; // TryYield left it locked
+	if (Consumer)
+		Consumer->Promise->Resume();
+	return true;
+}
+
+void FAsyncGeneratorYieldAwaiter::Suspend(FPromise& InPromise)
+{
+	{
+		UE::TUniqueLock L(InPromise.GetLock());
+		checkf(State.Lock.IsLocked(),
+		       TEXT("Internal error: unguarded suspension"));
+		if (InPromise.RegisterCancelableAwaiter(this))
+			State.Producer = &InPromise;
+		else
+			FAsyncYieldAwaiter::Suspend(InPromise);
+	}
+	// This object might be gone as soon as the lock is released
+	auto* Node = Consumer;
+	State.Lock.Unlock();
+	if (Node)
+		Node->Promise->Resume();
+}
+
+void FAsyncGeneratorYieldAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto& State = static_cast<FAsyncGeneratorYieldAwaiter*>(This)->State;
+		UE::TUniqueLock L(State.Lock);
+		// If the producer is not parked, a consumer is resuming it, and it
+		// will finish the cancellation
+		if (std::exchange(State.Producer, nullptr))
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
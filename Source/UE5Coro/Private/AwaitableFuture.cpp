@@ -0,0 +1,129 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/AwaitableFuture.h"
+#include "UE5Coro/AsyncAwaiter.h"
+
+using namespace UE5Coro::Private;
+
+namespace
+{
+// Completion markers for FAwaitableStateBase::Waiter
+void* const Ready = reinterpret_cast<void*>(1);
+void* const Abandoned = reinterpret_cast<void*>(2);
+}
+
+bool FAwaitableStateBase::IsReady() const
+{
+	return Waiter.load(std::memory_order_acquire) == Ready;
+}
+
+bool FAwaitableStateBase::IsAbandoned() const
+{
+	return Waiter.load(std::memory_order_acquire) == Abandoned;
+}
+
+void FAwaitableStateBase::Complete(bool bAbandoned)
+{
+	auto* Old = Waiter.exchange(bAbandoned ? Abandoned : Ready,
+	                            std::memory_order_acq_rel);
+	checkf(Old != Ready && Old != Abandoned,
+	       TEXT("Internal error: double TAwaitablePromise completion"));
+	if (!Old)
+		return;
+
+	// Whoever unregisters the awaiter resumes the coroutine, see Cancel
+	auto* Promise = static_cast<FPromise*>(Old);
+	if (bAbandoned)
+	{
+		UE::TUniqueLock Lock(Promise->GetLock());
+		ResumeAbandoned(*Promise);
+	}
+	else if (Promise->UnregisterCancelableAwaiter<true>())
+		Promise->Resume();
+}
+
+void FAwaitableStateBase::ResumeAbandoned(FPromise& Promise)
+{
+	checkf(Promise.GetLock().IsLocked(),
+	       TEXT("Internal error: expected guarded cancellation"));
+	Promise.Cancel(false);
+	// If cancellation is held, the coroutine is still registered, and it will
+	// see the abandoned state in await_resume
+	if (Promise.UnregisterCancelableAwaiter<false>())
+		FAsyncYieldAwaiter::Suspend(Promise);
+}
+
+bool FAwaitableFutureAwaiter::await_ready() const
+{
+	return State->IsReady();
+}
+
+void FAwaitableFutureAwaiter::Suspend(FPromise& Promise)
+{
+	UE::TDynamicUniqueLock Lock(Promise.GetLock());
+	if (!Promise.RegisterCancelableAwaiter(this))
+	{
+		FAsyncYieldAwaiter::Suspend(Promise); // Process the cancellation
+		return;
+	}
+
+	void* Expected = nullptr;
+	if (State->Waiter.compare_exchange_strong(Expected, &Promise,
+	                                          std::memory_order_acq_rel))
+		return; // Complete() will resume the coroutine
+
+	checkf(Expected == Ready || Expected == Abandoned,
+	       TEXT("TAwaitableFuture may only be awaited by one coroutine at a time"));
+	if (Expected == Abandoned)
+	{
+		ResumeAbandoned(Promise);
+		return;
+	}
+
+	// The value arrived after await_ready, continue synchronously
+	verifyf(Promise.UnregisterCancelableAwaiter<false>(),
+	        TEXT("Internal error: unexpected race condition"));
+	Lock.Unlock();
+	Promise.Resume();
+}
+
+void FAwaitableFutureAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		// This fails if Complete() already took the promise, which is fine
+		void* Expected = &Promise;
+		static_cast<FAwaitableFutureAwaiter*>(This)->State->Waiter
+			.compare_exchange_strong(Expected, nullptr);
+		FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
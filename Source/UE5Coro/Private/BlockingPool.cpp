@@ -0,0 +1,193 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "BlockingPool.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "UE5Coro/Promise.h"
+
+using namespace UE5Coro::Private;
+
+namespace
+{
+TAutoConsoleVariable<int32> CVarBlockingPoolMaxThreads(
+	TEXT("UE5Coro.BlockingPool.MaxThreads"), 64,
+	TEXT("Maximum number of threads in the MoveToBlockingPool thread pool. "
+	     "Coroutines are queued if every thread is busy."));
+
+TAutoConsoleVariable<float> CVarBlockingPoolIdleTimeout(
+	TEXT("UE5Coro.BlockingPool.IdleTimeout"), 30,
+	TEXT("Seconds after which an idle MoveToBlockingPool thread exits."));
+}
+
+namespace UE5Coro::Private
+{
+class FBlockingPoolWorker final : public FRunnable
+{
+	std::atomic<FRunnableThread*> Thread = nullptr;
+	FEventRef WakeEvent; // Auto reset
+	EThreadPriority Priority;
+	uint64 Affinity;
+
+public:
+	FBlockingPool::FWork Work;
+
+	explicit FBlockingPoolWorker(const FBlockingPool::FWork& Work)
+		: Priority(Work.Priority), Affinity(Work.Affinity), Work(Work)
+	{
+		// Thread has to start as nullptr and get overwritten later
+		Thread = FRunnableThread::Create(this, TEXT("UE5Coro Blocking Pool"), 0,
+		                                 Priority, Affinity);
+		checkf(Thread, TEXT("Internal error: could not create thread"));
+	}
+
+	void Wake() { WakeEvent->Trigger(); }
+
+	virtual uint32 Run() override;
+	virtual void Exit() override;
+
+private:
+	void ApplySettings();
+};
+}
+
+uint32 FBlockingPoolWorker::Run()
+{
+	auto& Pool = FBlockingPool::Get();
+	for (;;)
+	{
+		do
+		{
+			ApplySettings();
+			Work.Promise->Resume();
+		} while (Pool.TakeQueued(*this));
+
+		// TakeQueued returned this worker to the idle list
+		auto Timeout = FTimespan::FromSeconds(
+			CVarBlockingPoolIdleTimeout.GetValueOnAnyThread());
+		while (!WakeEvent->Wait(Timeout))
+			if (Pool.TryRetire(*this))
+				return 0;
+	}
+}
+
+void FBlockingPoolWorker::Exit()
+{
+	// This thread cannot join itself
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this]
+	{
+		FRunnableThread* ThreadPtr = Thread.load();
+
+		// Rare case of exiting so quickly, Thread is still nullptr
+		if (ThreadPtr == nullptr) [[unlikely]]
+		{
+			Exit(); // Try again later from another AsyncTask
+			return;
+		}
+
+		ThreadPtr->WaitForCompletion();
+		delete ThreadPtr;
+		delete this;
+	});
+}
+
+void FBlockingPoolWorker::ApplySettings()
+{
+	if (Priority != Work.Priority)
+	{
+		Priority = Work.Priority;
+		FRunnableThread::GetRunnableThread()->SetThreadPriority(Priority);
+	}
+	if (Affinity != Work.Affinity)
+	{
+		Affinity = Work.Affinity;
+		FPlatformProcess::SetThreadAffinityMask(Affinity);
+	}
+}
+
+std::once_flag FBlockingPool::Once;
+FBlockingPool* FBlockingPool::Instance;
+
+FBlockingPool& FBlockingPool::Get()
+{
+	std::call_once(Once, [] { Instance = new FBlockingPool; });
+	return *Instance;
+}
+
+void FBlockingPool::Schedule(FPromise& Promise, EThreadPriority Priority,
+                             uint64 Affinity)
+{
+	FWork Work{&Promise, Priority, Affinity};
+	{
+		UE::TUniqueLock L(Lock);
+		if (Idle.Num() > 0)
+		{
+			// Reuse the most recently active thread, let the others time out
+			auto* Worker = Idle.Pop();
+			Worker->Work = Work;
+			Worker->Wake();
+			return;
+		}
+		if (NumThreads >= CVarBlockingPoolMaxThreads.GetValueOnAnyThread())
+		{
+			Queue.Add(Work);
+			return;
+		}
+		++NumThreads;
+	}
+	// Thread creation is slow, do it outside the lock
+	new FBlockingPoolWorker(Work);
+}
+
+bool FBlockingPool::TakeQueued(FBlockingPoolWorker& Worker)
+{
+	UE::TUniqueLock L(Lock);
+	if (Queue.Num() > 0)
+	{
+		Worker.Work = Queue[0];
+		Queue.RemoveAt(0);
+		return true;
+	}
+	Idle.Add(&Worker);
+	return false;
+}
+
+bool FBlockingPool::TryRetire(FBlockingPoolWorker& Worker)
+{
+	UE::TUniqueLock L(Lock);
+	// If the worker is no longer idle, it was given work, and it will wake up
+	if (!Idle.RemoveSingle(&Worker))
+		return false;
+	--NumThreads;
+	return true;
+}
@@ -0,0 +1,314 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/BroadcastChannel.h"
+#include "UE5Coro/AsyncAwaiter.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+// Resumes nodes that were taken out of their queue with the lock held
+void ResumeAll(FWaitNode* Nodes)
+{
+	while (auto* Node = Nodes)
+	{
+		Nodes = Node->Next; // Node might be gone after Resume()
+		auto& Promise = *Node->Promise;
+		if (Promise.UnregisterCancelableAwaiter<true>())
+			Promise.Resume();
+		else // Cancel() ran, but it found the node already gone
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+}
+
+FBroadcastChannelBase::FBroadcastChannelBase(int Capacity,
+                                             EBroadcastOverflow Overflow)
+	: Capacity(Capacity), Overflow(Overflow)
+{
+	checkf(Capacity > 0, TEXT("Invalid capacity"));
+	checkf(Overflow == EBroadcastOverflow::DropOldest ||
+	       Overflow == EBroadcastOverflow::BlockPublisher,
+	       TEXT("Invalid overflow policy"));
+}
+
+FBroadcastChannelBase::~FBroadcastChannelBase()
+{
+#if UE5CORO_DEBUG
+	UE::TUniqueLock L(Lock);
+	checkf(Cursors.IsEmpty(),
+	       TEXT("Broadcast channel destroyed with active subscribers"));
+	checkf(Readers.IsEmpty() && Publishers.IsEmpty(),
+	       TEXT("Broadcast channel destroyed with active awaiters"));
+#endif
+}
+
+void FBroadcastChannelBase::Subscribe(FBroadcastCursor& Cursor)
+{
+	UE::TUniqueLock L(Lock);
+	Cursor.Position = Tail;
+	Cursors.Add(&Cursor);
+}
+
+void FBroadcastChannelBase::Unsubscribe(FBroadcastCursor& Cursor)
+{
+	Lock.Lock();
+	verifyf(Cursors.RemoveSingleSwap(&Cursor) == 1,
+	        TEXT("Internal error: unknown subscriber"));
+	// This might have been the slowest subscriber
+	bool bWake = !Publishers.IsEmpty();
+	Lock.Unlock();
+	if (bWake)
+		WakePublishers();
+}
+
+bool FBroadcastChannelBase::TryPublish(void* Item)
+{
+	FChannelWaitNode Node;
+	Node.Item = Item;
+	Lock.Lock();
+	if (!TryPublishLocked(Node) || !Node.bSucceeded)
+	{
+		Lock.Unlock();
+		return false;
+	}
+	auto* Waiting = Readers.TakeAll();
+	Lock.Unlock();
+	ResumeAll(Waiting);
+	return true;
+}
+
+bool FBroadcastChannelBase::TryNext(FBroadcastCursor& Cursor, void* Item)
+{
+	Lock.Lock();
+	// Skip values that were overwritten. This never happens with
+	// BlockPublisher, which doesn't overwrite values that someone still needs.
+	uint64 Head = Tail > Capacity ? Tail - Capacity : 0;
+	if (Cursor.Position < Head)
+	{
+		Cursor.NumDropped += Head - Cursor.Position;
+		Cursor.Position = Head;
+	}
+	if (Cursor.Position == Tail)
+	{
+		Lock.Unlock();
+		return false;
+	}
+	Load(Cursor.Position++, Item);
+	bool bWake = !Publishers.IsEmpty();
+	Lock.Unlock();
+	if (bWake)
+		WakePublishers();
+	return true;
+}
+
+void FBroadcastChannelBase::Close()
+{
+	Lock.Lock();
+	bClosed = true;
+	auto* WaitingReaders = Readers.TakeAll();
+	auto* WaitingPublishers = Publishers.TakeAll();
+	Lock.Unlock();
+	// Readers receive the rest of their values, publishers fail
+	ResumeAll(WaitingReaders);
+	ResumeAll(WaitingPublishers);
+}
+
+bool FBroadcastChannelBase::IsClosed()
+{
+	UE::TUniqueLock L(Lock);
+	return bClosed;
+}
+
+bool FBroadcastChannelBase::IsFull() const
+{
+	checkf(Lock.IsLocked(), TEXT("Internal error: unguarded channel access"));
+	if (Overflow == EBroadcastOverflow::DropOldest)
+		return false;
+	for (auto* Cursor : Cursors)
+		if (Tail - Cursor->Position >= Capacity)
+			return true;
+	return false;
+}
+
+// Returns true if Node is done, i.e., it was published or the channel is closed
+bool FBroadcastChannelBase::TryPublishLocked(FChannelWaitNode& Node)
+{
+	checkf(Lock.IsLocked(), TEXT("Internal error: unguarded channel access"));
+	if (bClosed)
+		return true;
+	if (IsFull())
+		return false;
+	Store(Tail++, Node.Item);
+	Node.bSucceeded = true;
+	return true;
+}
+
+// Called with Lock held, returns with it released
+void FBroadcastChannelBase::Park(FChannelWaitNode& Node, FPromise& Promise,
+                                 bool bFront)
+{
+	{
+		UE::TUniqueLock L(Promise.GetLock());
+		if (Promise.RegisterCancelableAwaiter(Node.Awaiter))
+		{
+			Node.Promise = &Promise;
+			if (bFront)
+				Publishers.PushFront(Node);
+			else
+				Publishers.PushBack(Node);
+		}
+		else
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+	Lock.Unlock();
+}
+
+void FBroadcastChannelBase::WakePublishers()
+{
+	for (;;)
+	{
+		Lock.Lock();
+		auto* Node = static_cast<FChannelWaitNode*>(Publishers.PopFront());
+		Lock.Unlock();
+		if (!Node)
+			return;
+
+		auto& Promise = *Node->Promise;
+		if (!Promise.UnregisterCancelableAwaiter<true>())
+		{
+			// Cancel() ran, but it found the node already gone
+			FAsyncYieldAwaiter::Suspend(Promise);
+			continue;
+		}
+
+		// The coroutine can no longer be canceled, but another publisher
+		// might have taken the room that was made for it
+		Lock.Lock();
+		if (!TryPublishLocked(*Node))
+		{
+			Park(*Node, Promise, true); // Keep its place in line
+			return;
+		}
+		auto* Waiting = Node->bSucceeded ? Readers.TakeAll() : nullptr;
+		Lock.Unlock();
+		Promise.Resume(); // Node is gone after this
+		ResumeAll(Waiting);
+	}
+}
+
+bool FBroadcastNextAwaiter::TryNext(void* Item)
+{
+	return Channel.TryNext(Cursor, Item);
+}
+
+bool FBroadcastNextAwaiter::await_ready()
+{
+	Channel.Lock.Lock();
+	if (Cursor.Position != Channel.Tail || Channel.bClosed)
+	{
+		Channel.Lock.Unlock();
+		return true; // await_resume will read the value
+	}
+	return false; // Leave Lock locked
+}
+
+void FBroadcastNextAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(Channel.Lock.IsLocked(),
+	       TEXT("Internal error: unguarded suspension"));
+	{
+		UE::TUniqueLock L(Promise.GetLock());
+		if (Promise.RegisterCancelableAwaiter(this))
+		{
+			Node.Promise = &Promise;
+			Channel.Readers.PushBack(Node);
+		}
+		else
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+	Channel.Lock.Unlock();
+}
+
+void FBroadcastNextAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FBroadcastNextAwaiter*>(This);
+		UE::TUniqueLock L(Awaiter->Channel.Lock);
+		// If the node is not queued, it was already taken by a publisher, which
+		// will finish the cancellation after the promise's lock is released
+		if (Awaiter->Channel.Readers.Remove(Awaiter->Node))
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
+FBroadcastPublishAwaiter::FBroadcastPublishAwaiter(
+	FBroadcastChannelBase& Channel, void* Item)
+	: TCancelableAwaiter(&Cancel), Channel(Channel)
+{
+	Node.Awaiter = this;
+	Node.Item = Item;
+}
+
+bool FBroadcastPublishAwaiter::await_ready()
+{
+	Channel.Lock.Lock();
+	if (!Channel.TryPublishLocked(Node))
+		return false; // Leave Lock locked
+
+	auto* Waiting = Node.bSucceeded ? Channel.Readers.TakeAll() : nullptr;
+	Channel.Lock.Unlock();
+	ResumeAll(Waiting);
+	return true;
+}
+
+void FBroadcastPublishAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(Channel.Lock.IsLocked(),
+	       TEXT("Internal error: unguarded suspension"));
+	Channel.Park(Node, Promise, false);
+}
+
+void FBroadcastPublishAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FBroadcastPublishAwaiter*>(This);
+		UE::TUniqueLock L(Awaiter->Channel.Lock);
+		// If the node is not queued, it was already taken by WakePublishers(),
+		// which will finish the cancellation after the promise's lock is released
+		if (Awaiter->Channel.Publishers.Remove(Awaiter->Node))
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
@@ -108,3 +108,176 @@ void FCancellationAwaiter::Suspend(FPromise& Promise)
 	// Resume is also responsible for cancellation-induced self-destruction
 	Promise.Resume();
 }
+
+// Shared by the source and its tokens, and kept alive by linked coroutines
+class UE5Coro::Private::FCancellationState final
+{
+	UE::FMutex Lock;
+	std::atomic<bool> bCanceled = false;
+	FCancellationNode* Head = nullptr;
+
+public:
+	[[nodiscard]] static const std::shared_ptr<FCancellationState>& Get(
+		const FCancellationToken& Token) noexcept
+	{
+		return Token.State;
+	}
+
+	[[nodiscard]] bool IsCanceled() const noexcept
+	{
+		return bCanceled.load(std::memory_order_acquire);
+	}
+
+	// Returns true if the promise was canceled due to this link
+	[[nodiscard]] static bool Link(FPromiseExtras& Extras,
+	                               const std::shared_ptr<FCancellationState>& This)
+	{
+		UE::TUniqueLock L(This->Lock);
+		UE::TUniqueLock PromiseLock(Extras.Lock);
+		// Holding the lock guarantees that Promise is active in the union
+		auto* Promise = Extras.Promise;
+		if (!Promise) // Already completed
+			return false;
+
+		if (!Promise->CancellationNode)
+		{
+			Promise->CancellationNode = new FCancellationNode;
+			Promise->CancellationNode->Fn = &OnCompleted;
+			Promise->CancellationNode->Promise = Promise;
+			Promise->AddContinuation(*Promise->CancellationNode);
+		}
+		auto& Node = *Promise->CancellationNode;
+		checkf(!Node.State, TEXT("Coroutine is already linked for cancellation"));
+		Node.State = This;
+		Node.LinkPrev = nullptr;
+		Node.LinkNext = std::exchange(This->Head, &Node);
+		if (Node.LinkNext)
+			Node.LinkNext->LinkPrev = &Node;
+
+		if (!This->bCanceled)
+			return false;
+		Promise->Cancel(false);
+		return true;
+	}
+
+	// Only valid while the promise cannot be destroyed on another thread
+	static void Unlink(FPromise& Promise)
+	{
+		FCancellationNode* Node;
+		std::shared_ptr<FCancellationState> This;
+		{
+			UE::TUniqueLock PromiseLock(Promise.GetLock());
+			// Once allocated, the node stays until the promise completes
+			Node = Promise.CancellationNode;
+			if (Node)
+				This = Node->State;
+		}
+		if (!This)
+			return;
+
+		UE::TUniqueLock L(This->Lock);
+		UE::TUniqueLock PromiseLock(Promise.GetLock());
+		(Node->LinkPrev ? Node->LinkPrev->LinkNext : This->Head) =
+			Node->LinkNext;
+		if (Node->LinkNext)
+			Node->LinkNext->LinkPrev = Node->LinkPrev;
+		Node->State = nullptr; // This keeps the state alive until the unlocks
+	}
+
+	void Cancel()
+	{
+		{
+			UE::TUniqueLock L(Lock);
+			bCanceled.store(true, std::memory_order_release);
+			// Linked promises cannot unlink themselves while the lock is held,
+			// their nodes remain valid for the duration of this loop
+			for (auto* Node = Head; Node; Node = Node->LinkNext)
+			{
+				auto* Promise = Node->Promise;
+				UE::TUniqueLock PromiseLock(Promise->GetLock());
+				if (Promise->Extras->Promise) // Is it already completing?
+					Promise->Cancel(false);
+			}
+		}
+		ProcessExpeditedCancellations();
+	}
+
+	// Like TCoroutine::Cancel, expedited cancellations wait for the locks
+	static void ProcessExpeditedCancellations()
+	{
+		if (GCancelableAwaiterDepth == 0 && IsInGameThread())
+			FLatentPromise::ProcessExpeditedCancellations();
+	}
+
+	static void Link(const FCancellationToken& Token, const TCoroutine<>& Coro)
+	{
+		if (Token.State && Link(*Coro.Extras, Token.State))
+			ProcessExpeditedCancellations();
+	}
+
+private:
+	static void OnCompleted(FContinuationNode* Node, void*)
+	{
+		// Called from the promise's destructor, nothing else uses Node after
+		Unlink(*static_cast<FCancellationNode*>(Node)->Promise);
+		delete static_cast<FCancellationNode*>(Node);
+	}
+};
+
+FCancellationToken::FCancellationToken(
+	std::shared_ptr<FCancellationState> State)
+	: State(std::move(State))
+{
+}
+
+bool FCancellationToken::IsCancellationRequested() const noexcept
+{
+	return State && State->IsCanceled();
+}
+
+FCancellationSource::FCancellationSource()
+	: State(std::make_shared<FCancellationState>())
+{
+}
+
+FCancellationToken FCancellationSource::GetToken() const
+{
+	return FCancellationToken(State);
+}
+
+void FCancellationSource::Cancel()
+{
+	State->Cancel();
+}
+
+bool FCancellationSource::IsCancellationRequested() const noexcept
+{
+	return State->IsCanceled();
+}
+
+FLinkCancellationAwaiter UE5Coro::LinkCancellation(FCancellationToken Token)
+{
+	return FLinkCancellationAwaiter(std::move(Token));
+}
+
+void UE5Coro::LinkCancellation(const FCancellationToken& Token,
+                               const TCoroutine<>& Coroutine)
+{
+	FCancellationState::Link(Token, Coroutine);
+}
+
+bool FLinkCancellationAwaiter::await_ready()
+{
+	auto& Promise = FPromise::Current();
+	FCancellationState::Unlink(Promise);
+	if (auto& State = FCancellationState::Get(Token))
+		// The co_await processes the cancellation, don't expedite it
+		std::ignore = FCancellationState::Link(*Promise.Extras, State);
+	return !Promise.ShouldCancel(false);
+}
+
+void FLinkCancellationAwaiter::Suspend(FPromise& Promise)
+{
+	// Resume is also responsible for cancellation-induced self-destruction
+	Promise.Resume();
+}
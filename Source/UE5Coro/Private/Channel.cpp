@@ -0,0 +1,243 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/Channel.h"
+#include "UE5Coro/AsyncAwaiter.h"
+
+using namespace UE5Coro::Private;
+
+FChannelBase::~FChannelBase()
+{
+#if UE5CORO_DEBUG
+	UE::TUniqueLock L(Lock);
+	checkf(Senders.IsEmpty() && Receivers.IsEmpty(),
+	       TEXT("Channel destroyed with active awaiters"));
+#endif
+}
+
+void FChannelBase::Close()
+{
+	auto TakeAll = [](FWaitQueue& Queue, std::atomic<int>& NumWaiting)
+	{
+		auto* Nodes = Queue.TakeAll();
+		// Wake() might be retrying other awaiters, don't reset this to 0
+		for (auto* Node = Nodes; Node; Node = Node->Next)
+			--NumWaiting;
+		return Nodes;
+	};
+
+	Lock.Lock();
+	bClosed = true;
+	// Nodes that are being resumed by Wake() will see the flag when they retry
+	auto* SenderNodes = TakeAll(Senders, NumSenders);
+	auto* ReceiverNodes = TakeAll(Receivers, NumReceivers);
+	Lock.Unlock();
+
+	ResumeClosed(SenderNodes, true);
+	ResumeClosed(ReceiverNodes, false);
+}
+
+void FChannelBase::ResumeClosed(FWaitNode* Nodes, bool bSend)
+{
+	while (auto* Node = static_cast<FChannelWaitNode*>(Nodes))
+	{
+		Nodes = Node->Next; // Node might be gone after Resume()
+		auto& Promise = *Node->Promise;
+		if (Promise.UnregisterCancelableAwaiter<true>())
+		{
+			// Receivers might still get a value that was sent concurrently
+			verifyf(TryComplete(*Node, bSend),
+			        TEXT("Internal error: unexpected open channel"));
+			Promise.Resume();
+		}
+		else // Cancel() ran, but it found the node already gone
+			FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
+bool FChannelBase::IsClosed() const noexcept
+{
+	return bClosed.load(std::memory_order_relaxed);
+}
+
+void FChannelBase::Notify(bool bSent)
+{
+	// Pairs with the fence in FChannelAwaiter::await_ready: either this thread
+	// sees the waiter, or the waiter sees this thread's change to the buffer
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if ((bSent ? NumReceivers : NumSenders).load(std::memory_order_relaxed))
+		Wake(!bSent);
+}
+
+bool FChannelBase::TryComplete(FChannelWaitNode& Node, bool bSend)
+{
+	if (bSend && IsClosed())
+		return true; // Closed channels never accept values
+	if (bSend ? TryPush(Node.Item) : TryPop(Node.Item))
+	{
+		Node.bSucceeded = true;
+		return true;
+	}
+	return !bSend && IsClosed(); // Closed and drained
+}
+
+// Called with Lock held and the node counted in NumSenders or NumReceivers,
+// returns with Lock released
+void FChannelBase::Park(FChannelWaitNode& Node, FPromise& Promise, bool bSend,
+                        bool bFront)
+{
+	{
+		UE::TUniqueLock L(Promise.GetLock());
+		if (Promise.RegisterCancelableAwaiter(Node.Awaiter))
+		{
+			auto& Queue = bSend ? Senders : Receivers;
+			Node.Promise = &Promise;
+			if (bFront)
+				Queue.PushFront(Node);
+			else
+				Queue.PushBack(Node);
+		}
+		else
+		{
+			--(bSend ? NumSenders : NumReceivers);
+			FAsyncYieldAwaiter::Suspend(Promise);
+		}
+	}
+	Lock.Unlock();
+}
+
+void FChannelBase::Wake(bool bSenders)
+{
+	auto& Queue = bSenders ? Senders : Receivers;
+	auto& NumWaiting = bSenders ? NumSenders : NumReceivers;
+	for (;;)
+	{
+		Lock.Lock();
+		auto* Node = static_cast<FChannelWaitNode*>(Queue.PopFront());
+		if (!Node)
+		{
+			Lock.Unlock();
+			return;
+		}
+		Lock.Unlock();
+
+		auto& Promise = *Node->Promise;
+		if (!Promise.UnregisterCancelableAwaiter<true>())
+		{
+			// Cancel() ran, but it found the node already gone
+			Lock.Lock();
+			--NumWaiting;
+			Lock.Unlock();
+			FAsyncYieldAwaiter::Suspend(Promise);
+			continue;
+		}
+
+		// The coroutine can no longer be canceled, but something else might
+		// have used up the buffer since this was called. Retry while still
+		// being counted as a waiter, so that a concurrent Notify sees it.
+		Lock.Lock();
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!TryComplete(*Node, bSenders))
+		{
+			Park(*Node, Promise, bSenders, true); // Keep its place in line
+			return;
+		}
+		--NumWaiting;
+		Lock.Unlock();
+
+		bool bTransferred = Node->bSucceeded;
+		Promise.Resume(); // Node is gone after this
+		if (bTransferred)
+			Notify(bSenders);
+	}
+}
+
+void FChannelBase::Cancel(FChannelWaitNode& Node, FPromise& Promise,
+                          bool bSend)
+{
+	checkf(Promise.GetLock().IsLocked(), // The promise's lock
+	       TEXT("Internal error: expected guarded cancellation"));
+	UE::TUniqueLock L(Lock);
+	// If the node is not queued, it was already taken by Wake() or Close(),
+	// which will finish the cancellation after the promise's lock is released
+	if ((bSend ? Senders : Receivers).Remove(Node))
+	{
+		--(bSend ? NumSenders : NumReceivers);
+		// Calling Resume() synchronously from Cancel() would complicate things
+		FAsyncYieldAwaiter::Suspend(Promise);
+	}
+}
+
+FChannelAwaiter::FChannelAwaiter(FChannelBase& Channel, bool bSend, void* Item)
+	: TCancelableAwaiter(&Cancel), Channel(Channel), bSend(bSend)
+{
+	Node.Awaiter = this;
+	Node.Item = Item;
+}
+
+bool FChannelAwaiter::await_ready()
+{
+	if (Channel.TryComplete(Node, bSend)) [[likely]]
+	{
+		if (Node.bSucceeded)
+			Channel.Notify(bSend);
+		return true;
+	}
+
+	Channel.Lock.Lock();
+	// Announce this coroutine as a waiter, then look again, see Notify
+	++(bSend ? Channel.NumSenders : Channel.NumReceivers);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (Channel.TryComplete(Node, bSend))
+	{
+		--(bSend ? Channel.NumSenders : Channel.NumReceivers);
+		Channel.Lock.Unlock();
+		if (Node.bSucceeded)
+			Channel.Notify(bSend);
+		return true;
+	}
+	return false; // Leave Lock locked
+}
+
+void FChannelAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(Channel.Lock.IsLocked(), TEXT("Internal error: unguarded suspension"));
+	Channel.Park(Node, Promise, bSend, false);
+}
+
+void FChannelAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FChannelAwaiter*>(This);
+		Awaiter->Channel.Cancel(Awaiter->Node, Promise, Awaiter->bSend);
+	}
+}
@@ -31,6 +31,7 @@
 
 #include "UE5Coro/Coroutine.h"
 #include "UE5Coro/Cancellation.h"
+#include "UE5Coro/Promise.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
@@ -47,10 +48,17 @@ const TCoroutine<> TCoroutine<>::FailedCoroutine = []() -> TCoroutine
 
 void TCoroutine<>::Cancel()
 {
-	UE::TUniqueLock Lock(Extras->Lock);
-	// Holding the lock guarantees that Promise is active in the union
-	if (Extras->Promise)
-		Extras->Promise->Cancel(false);
+	{
+		UE::TUniqueLock Lock(Extras->Lock);
+		// Holding the lock guarantees that Promise is active in the union
+		if (Extras->Promise)
+			Extras->Promise->Cancel(false);
+	}
+
+	// Latent coroutines canceled on the game thread don't wait for their next
+	// poll, unless this is nested in another cancellation that's holding a lock
+	if (GCancelableAwaiterDepth == 0 && IsInGameThread())
+		FLatentPromise::ProcessExpeditedCancellations();
 }
 
 bool TCoroutine<>::Wait(uint32 WaitTimeMilliseconds,
@@ -34,20 +34,6 @@
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
-namespace
-{
-bool ShouldResumeLatentCoroutine(void* State, bool bCleanup)
-{
-	auto* This = static_cast<TCoroutine<>*>(State);
-	if (bCleanup) [[unlikely]]
-	{
-		delete This;
-		return false;
-	}
-	return This->IsDone();
-}
-}
-
 FAsyncCoroutineAwaiter::FAsyncCoroutineAwaiter(TCoroutine<>&& Antecedent)
 	: TCancelableAwaiter(&Cancel), Antecedent(std::move(Antecedent))
 {
@@ -91,8 +77,30 @@ void FAsyncCoroutineAwaiter::Cancel(void* This, FPromise& Promise)
 	}
 }
 
+// State points to the awaiter itself instead of a separate allocation.
+// The awaiter does not move once it's co_awaited, so this is safe to poll.
 FLatentCoroutineAwaiter::FLatentCoroutineAwaiter(TCoroutine<>&& Antecedent)
-	: FLatentAwaiter(new TCoroutine<>(std::move(Antecedent)),
-	                 &ShouldResumeLatentCoroutine, std::false_type())
+	: FLatentAwaiter(this, &ShouldResume, std::false_type()),
+	  Antecedent(std::move(Antecedent))
 {
 }
+
+FLatentCoroutineAwaiter::FLatentCoroutineAwaiter(
+	FLatentCoroutineAwaiter&& Other) noexcept
+	: FLatentAwaiter(std::move(Other)), Antecedent(std::move(Other.Antecedent))
+{
+	if (Resume) // Don't arm a moved-from awaiter
+		State = this;
+}
+
+bool FLatentCoroutineAwaiter::ShouldResume(void* State, bool bCleanup)
+{
+	// Antecedent is a member, and it's already destroyed at this point
+	if (bCleanup) [[unlikely]]
+		return false;
+
+	// The antecedent publishes its completion, there's no need to poll its
+	// event, which might involve a system call
+	auto* This = static_cast<FLatentCoroutineAwaiter*>(State);
+	return This->Antecedent.Extras->bDone;
+}
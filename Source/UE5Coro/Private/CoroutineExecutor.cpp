@@ -0,0 +1,258 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/CoroutineExecutor.h"
+#include "WorkStealingDeque.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace UE5Coro::Private
+{
+class FExecutorWorker final
+{
+	FCoroutineExecutor& Executor;
+	FEventRef WakeEvent; // Auto reset
+
+public:
+	FWorkStealingDeque Deque;
+	FThread Thread; // This one must come last
+
+	explicit FExecutorWorker(FCoroutineExecutor& Executor)
+		: Executor(Executor) { }
+	UE_NONCOPYABLE(FExecutorWorker);
+
+	void Start(int32 Index, EThreadPriority Priority);
+
+	bool IsOwnedBy(const FCoroutineExecutor& Other) const
+	{
+		return &Executor == &Other;
+	}
+	void Wake() { WakeEvent->Trigger(); }
+
+private:
+	void Run();
+	[[nodiscard]] FPromise* FindWork();
+	void Sleep();
+};
+}
+
+namespace
+{
+thread_local FExecutorWorker* GCurrentWorker = nullptr;
+}
+
+void FExecutorWorker::Start(int32 Index, EThreadPriority Priority)
+{
+	Thread = FThread(*FString::Printf(TEXT("UE5Coro Executor Worker %d"), Index),
+	                 [this] { Run(); }, 0, Priority);
+}
+
+void FExecutorWorker::Run()
+{
+	GCurrentWorker = this;
+	for (;;)
+	{
+		if (auto* Promise = FindWork())
+			Promise->Resume();
+		else if (Executor.bStopping)
+			break; // Nothing is left to drain
+		else
+			Sleep();
+	}
+	GCurrentWorker = nullptr;
+}
+
+FPromise* FExecutorWorker::FindWork()
+{
+	if (auto* Promise = Deque.Pop())
+		return Promise;
+	if (auto* Promise = Executor.TakeInjected(*this))
+		return Promise;
+	return Executor.Steal(*this);
+}
+
+void FExecutorWorker::Sleep()
+{
+	{
+		UE::TUniqueLock Lock(Executor.Lock);
+		Executor.Idle.Add(this);
+		++Executor.NumIdle;
+	}
+	// Pairs with the fence in WakeOne. Either this thread sees the new work,
+	// or the scheduling thread sees this worker as idle.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (Executor.HasWork() || Executor.bStopping)
+	{
+		UE::TUniqueLock Lock(Executor.Lock);
+		if (Executor.Idle.RemoveSingleSwap(this))
+		{
+			--Executor.NumIdle;
+			return;
+		}
+		// Someone else removed this worker, and it will trigger the event
+	}
+	WakeEvent->Wait();
+}
+
+FCoroutineExecutor::FCoroutineExecutor(int32 NumWorkers,
+                                       EThreadPriority Priority)
+{
+	if (NumWorkers <= 0)
+		NumWorkers = FMath::Max(1, FPlatformMisc::NumberOfCores());
+	Workers.Reserve(NumWorkers);
+	for (int32 i = 0; i < NumWorkers; ++i)
+		Workers.Add(std::make_unique<FExecutorWorker>(*this));
+	// Workers look at each other, start them after they all exist
+	for (int32 i = 0; i < NumWorkers; ++i)
+		Workers[i]->Start(i, Priority);
+}
+
+FCoroutineExecutor::~FCoroutineExecutor()
+{
+	checkf(!GCurrentWorker || !GCurrentWorker->IsOwnedBy(*this),
+	       TEXT("Executors cannot be destroyed from their own worker threads"));
+	bStopping = true;
+	TArray<FExecutorWorker*> Sleeping;
+	{
+		UE::TUniqueLock L(Lock);
+		Sleeping = std::move(Idle);
+		Idle.Reset();
+		NumIdle = 0;
+	}
+	for (auto* Worker : Sleeping)
+		Worker->Wake();
+	for (auto& Worker : Workers)
+		Worker->Thread.Join();
+	checkf(!Injected.load(),
+	       TEXT("Coroutines were scheduled on a destroyed executor"));
+}
+
+FCoroutineExecutor& FCoroutineExecutor::Get()
+{
+	// Intentionally leaked, like the timer thread
+	static auto* Instance = new FCoroutineExecutor;
+	return *Instance;
+}
+
+int32 FCoroutineExecutor::GetNumWorkers() const noexcept
+{
+	return Workers.Num();
+}
+
+void FCoroutineExecutor::Schedule(FPromise& Promise)
+{
+	// Coroutines moving within this executor don't need the lock
+	if (GCurrentWorker && GCurrentWorker->IsOwnedBy(*this)) [[likely]]
+		GCurrentWorker->Deque.Push(&Promise);
+	else
+	{
+		checkf(!bStopping,
+		       TEXT("Attempting to schedule a coroutine on a stopping executor"));
+		checkf(!Promise.ScheduleNext,
+		       TEXT("Internal error: promise is already scheduled"));
+		auto* Head = Injected.load(std::memory_order_relaxed);
+		do
+			Promise.ScheduleNext = Head;
+		while (!Injected.compare_exchange_weak(Head, &Promise,
+		                                       std::memory_order_release,
+		                                       std::memory_order_relaxed));
+	}
+	WakeOne();
+}
+
+void FCoroutineExecutor::WakeOne()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (NumIdle.load(std::memory_order_relaxed) == 0)
+		return;
+
+	FExecutorWorker* Worker = nullptr;
+	{
+		UE::TUniqueLock L(Lock);
+		if (!Idle.IsEmpty())
+		{
+			Worker = Idle.Pop();
+			--NumIdle;
+		}
+	}
+	if (Worker)
+		Worker->Wake();
+}
+
+bool FCoroutineExecutor::HasWork() const
+{
+	if (Injected.load(std::memory_order_relaxed))
+		return true;
+	for (auto& Worker : Workers)
+		if (!Worker->Deque.IsEmpty())
+			return true;
+	return false;
+}
+
+FPromise* FCoroutineExecutor::TakeInjected(FExecutorWorker& Worker)
+{
+	if (!Injected.load(std::memory_order_relaxed))
+		return nullptr;
+	auto* List = Injected.exchange(nullptr, std::memory_order_acquire);
+	if (!List)
+		return nullptr;
+
+	// Run the oldest one, and make the rest available for stealing.
+	// The list is newest first, and Pop takes from the back of the deque, so
+	// pushing them in this order makes the worker continue with older ones.
+	bool bMore = false;
+	while (auto* Next = std::exchange(List->ScheduleNext, nullptr))
+	{
+		Worker.Deque.Push(List);
+		List = Next;
+		bMore = true;
+	}
+	if (bMore)
+		WakeOne();
+	return List;
+}
+
+FPromise* FCoroutineExecutor::Steal(FExecutorWorker& Thief)
+{
+	int32 Num = Workers.Num();
+	int32 Start = FMath::RandHelper(Num);
+	for (int32 i = 0; i < Num; ++i)
+		if (auto& Victim = Workers[(Start + i) % Num]; Victim.get() != &Thief)
+			if (auto* Promise = Victim->Deque.Steal())
+				return Promise;
+	return nullptr;
+}
+
+void FExecutorAwaiter::Suspend(FPromise& Promise)
+{
+	Executor.Schedule(Promise);
+}
@@ -0,0 +1,102 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "FrameTicker.h"
+#include "Containers/Ticker.h"
+#include "UE5Coro/AsyncAwaiter.h"
+
+using namespace UE5Coro::Private;
+
+std::once_flag FFrameTicker::Once;
+FFrameTicker* FFrameTicker::Instance;
+
+FFrameTicker& FFrameTicker::Get()
+{
+	std::call_once(Once, [] { Instance = new FFrameTicker; });
+	return *Instance;
+}
+
+void FFrameTicker::Register(FAsyncFrameAwaiter* Awaiter, FPromise& Promise)
+{
+	checkf(Promise.GetLock().IsLocked(),
+	       TEXT("Internal error: unguarded awaiter registration"));
+	checkf(Awaiter->Frames > 0, TEXT("Internal error: registering expired wait"));
+	UE::TUniqueLock L(Lock);
+	checkf(!Awaiter->Promise, TEXT("Internal error: double registration"));
+	Awaiter->Promise = &Promise;
+	Awaiter->TargetFrame = Frame + Awaiter->Frames;
+	Buckets[Awaiter->TargetFrame % NumBuckets].Add(Awaiter);
+}
+
+bool FFrameTicker::TryUnregister(FAsyncFrameAwaiter* Awaiter)
+{
+	UE::TUniqueLock L(Lock);
+	// If Tick already took this awaiter, it is responsible for resuming it
+	if (!Awaiter->Promise)
+		return false;
+	verifyf(Buckets[Awaiter->TargetFrame % NumBuckets].RemoveSingleSwap(Awaiter),
+	        TEXT("Internal error: registered awaiter not found"));
+	Awaiter->Promise = nullptr;
+	return true;
+}
+
+FFrameTicker::FFrameTicker()
+{
+	FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FFrameTicker::Tick));
+}
+
+bool FFrameTicker::Tick(float)
+{
+	checkf(Ready.IsEmpty(), TEXT("Internal error: unexpected reentrant tick"));
+	{
+		UE::TUniqueLock L(Lock);
+		auto& Bucket = Buckets[++Frame % NumBuckets];
+		int Kept = 0;
+		for (auto* Awaiter : Bucket)
+			if (Awaiter->TargetFrame <= Frame)
+				Ready.Add(std::exchange(Awaiter->Promise, nullptr));
+			else
+				Bucket[Kept++] = Awaiter;
+		Bucket.SetNum(Kept);
+	}
+
+	// Cancellations cannot claim these promises anymore, see TryUnregister.
+	// Resuming them will process any cancellation that arrived in the meantime.
+	for (auto* Promise : Ready)
+	{
+		verifyf(Promise->UnregisterCancelableAwaiter<true>(),
+		        TEXT("Internal error: unexpected race condition"));
+		Promise->Resume();
+	}
+	Ready.Reset();
+	return true; // Keep ticking
+}
@@ -0,0 +1,66 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <mutex>
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro::Private
+{
+/** Drives Async::NextFrame/Frames from FTSTicker, without needing a world. */
+class FFrameTicker final
+{
+	static std::once_flag Once;
+	static FFrameTicker* Instance;
+
+	// Hashed by target frame. Awaiters more than NumBuckets frames away are
+	// visited and skipped in the meantime, which is rare enough not to matter.
+	static constexpr int NumBuckets = 16;
+
+	UE::FMutex Lock;
+	uint64 Frame = 0;
+	TArray<FAsyncFrameAwaiter*> Buckets[NumBuckets];
+	TArray<FPromise*> Ready; // Only used by Tick
+
+public:
+	static FFrameTicker& Get();
+	void Register(FAsyncFrameAwaiter*, FPromise&);
+	[[nodiscard]] bool TryUnregister(FAsyncFrameAwaiter*);
+
+private:
+	explicit FFrameTicker();
+	~FFrameTicker() = delete;
+	bool Tick(float);
+};
+}
@@ -0,0 +1,154 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "GameThreadInbox.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "UE5Coro/Promise.h"
+
+using namespace UE5Coro::Private;
+
+DECLARE_STATS_GROUP(TEXT("UE5Coro"), STATGROUP_UE5Coro, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Game thread inbox drain"), STAT_UE5CoroInboxDrain,
+                   STATGROUP_UE5Coro);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Game thread inbox depth"),
+                               STAT_UE5CoroInboxDepth, STATGROUP_UE5Coro);
+
+namespace
+{
+TAutoConsoleVariable<float> CVarInboxBudget(
+	TEXT("UE5Coro.GameThreadInboxBudget"), 0,
+	TEXT("Resume coroutines on the game thread for at most this many "
+	     "milliseconds per batch, the rest continue in the next batch or "
+	     "frame. 0 means no limit."));
+}
+
+std::once_flag FGameThreadInbox::Once;
+FGameThreadInbox* FGameThreadInbox::Instance;
+
+FGameThreadInbox& FGameThreadInbox::Get()
+{
+	std::call_once(Once, [] { Instance = new FGameThreadInbox; });
+	return *Instance;
+}
+
+void FGameThreadInbox::Resume(FPromise& Promise)
+{
+	Push(Promise, false);
+}
+
+void FGameThreadInbox::Destroy(FPromise& Promise)
+{
+	Push(Promise, true);
+}
+
+FGameThreadInbox::FGameThreadInbox()
+{
+	// Leftovers from budgeted drains are picked up every frame
+	FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FGameThreadInbox::Tick));
+}
+
+void FGameThreadInbox::Push(FPromise& Promise, bool bDestroy)
+{
+	checkf(!Promise.ScheduleNext && !Promise.bInboxDestroy,
+	       TEXT("Internal error: promise is already in the inbox"));
+	Promise.bInboxDestroy = bDestroy;
+	auto* Head = Incoming.load(std::memory_order_relaxed);
+	do
+		Promise.ScheduleNext = Head;
+	while (!Incoming.compare_exchange_weak(Head, &Promise,
+	                                       std::memory_order_release,
+	                                       std::memory_order_relaxed));
+	++Depth;
+
+	// Only one task is needed for everything that arrives before it runs
+	if (!bTaskQueued.exchange(true))
+		AsyncTask(ENamedThreads::GameThread, [this] { Drain(); });
+}
+
+void FGameThreadInbox::Drain()
+{
+	checkf(IsInGameThread(), TEXT("Internal error: expected game thread drain"));
+	// Anything pushed after this will queue a new task
+	bTaskQueued = false;
+	SCOPE_CYCLE_COUNTER(STAT_UE5CoroInboxDrain);
+
+	// A coroutine might pump the task graph (e.g., a blocking load), which
+	// runs a nested drain. That's fine, promises are fully unlinked from
+	// the pending list before they're resumed, and the outer drain continues
+	// with whatever is left.
+	if (auto* List = Incoming.exchange(nullptr, std::memory_order_acquire))
+	{
+		// Restore FIFO order, and append it to the leftovers
+		auto* Tail = List;
+		FPromise* Reversed = nullptr;
+		while (List)
+		{
+			auto* Next = List->ScheduleNext;
+			List->ScheduleNext = Reversed;
+			Reversed = List;
+			List = Next;
+		}
+		if (PendingTail)
+			PendingTail->ScheduleNext = Reversed;
+		else
+			PendingHead = Reversed;
+		PendingTail = Tail;
+	}
+
+	auto Budget = CVarInboxBudget.GetValueOnGameThread() / 1000.0;
+	auto End = FPlatformTime::Seconds() + Budget;
+	while (PendingHead)
+	{
+		auto* Promise = PendingHead;
+		PendingHead = std::exchange(Promise->ScheduleNext, nullptr);
+		if (!PendingHead)
+			PendingTail = nullptr;
+		--Depth;
+		// The promise might enter the inbox again while it's running
+		if (std::exchange(Promise->bInboxDestroy, false))
+			Promise->ThreadSafeDestroy();
+		else
+			Promise->Resume();
+		if (Budget > 0 && FPlatformTime::Seconds() >= End)
+			break;
+	}
+	SET_DWORD_STAT(STAT_UE5CoroInboxDepth, Depth.load());
+}
+
+bool FGameThreadInbox::Tick(float)
+{
+	if (PendingHead || Incoming.load(std::memory_order_relaxed))
+		Drain();
+	return true; // Keep ticking
+}
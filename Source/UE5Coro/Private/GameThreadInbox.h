@@ -0,0 +1,72 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <atomic>
+#include <mutex>
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro::Private
+{
+/** Coalesces coroutines that need to continue on the game thread, and runs
+ *  them in batches from a single task instead of one task each. */
+class FGameThreadInbox final
+{
+	static std::once_flag Once;
+	static FGameThreadInbox* Instance;
+
+	// Lock-free LIFO of incoming promises, linked through FPromise::ScheduleNext
+	std::atomic<FPromise*> Incoming = nullptr;
+	std::atomic<bool> bTaskQueued = false;
+	std::atomic<int32> Depth = 0;
+
+	// Game thread only, in FIFO order. Budgeted drains leave leftovers here.
+	FPromise* PendingHead = nullptr;
+	FPromise* PendingTail = nullptr;
+
+public:
+	static FGameThreadInbox& Get();
+	/** Resumes the promise on the game thread. */
+	void Resume(FPromise&);
+	/** Calls ThreadSafeDestroy on the game thread. */
+	void Destroy(FPromise&);
+
+private:
+	explicit FGameThreadInbox();
+	~FGameThreadInbox() = delete;
+	void Push(FPromise&, bool bDestroy);
+	void Drain();
+	bool Tick(float);
+};
+}
@@ -37,6 +37,90 @@ using namespace UE5Coro::Private;
 thread_local FPromise* UE5Coro::Private::GCurrentPromise = nullptr;
 UWorldProxy UE5Coro::Private::GCurrentCoroWorld;
 thread_local bool UE5Coro::Private::GDestroyedEarly = false;
+thread_local int UE5Coro::Private::GCancelableAwaiterDepth = 0;
+
+namespace
+{
+// Only taken to register slots, blocks read the atomics without locking.
+// Sizes and alignments are written before the slot count is released.
+UE::FMutex GCoroutineLocalLock;
+std::atomic<int32> GNumCoroutineLocalSlots = 0;
+std::atomic<uint32> GCoroutineLocalSize = 0;
+std::atomic<uint32> GCoroutineLocalAlignment = 1;
+}
+
+// Storage for the values of the slots that existed when it was allocated, at
+// their global offsets relative to BaseOffset. Slots that are registered after
+// a coroutine allocated its block go into another block linked after it.
+struct UE5Coro::Private::FCoroutineLocalBlock final
+{
+	struct FEntry
+	{
+		void (*Destroy)(void*); // nullptr if the value is not constructed
+		uint32 Offset;
+	};
+
+	FCoroutineLocalBlock* Next;
+	int32 BeginSlot;
+	int32 EndSlot;
+	uint32 BaseOffset;
+	uint32 EndOffset;
+	uint32 DataOffset;
+	// Followed by EndSlot - BeginSlot FEntries, then the values
+
+	static FCoroutineLocalBlock* Allocate(int32 BeginSlot, uint32 BeginOffset)
+	{
+		int32 EndSlot = GNumCoroutineLocalSlots.load(std::memory_order_acquire);
+		uint32 EndOffset = GCoroutineLocalSize.load(std::memory_order_relaxed);
+		uint32 Alignment = FMath::Max<uint32>(
+			GCoroutineLocalAlignment.load(std::memory_order_relaxed),
+			alignof(FCoroutineLocalBlock));
+		checkf(EndSlot > BeginSlot, TEXT("Internal error: unknown slot"));
+
+		// BaseOffset and DataOffset are multiples of every slot's alignment,
+		// which keeps values at their offsets aligned
+		uint32 BaseOffset = AlignDown(BeginOffset, Alignment);
+		uint32 DataOffset = Align(sizeof(FCoroutineLocalBlock) +
+		                          sizeof(FEntry) * (EndSlot - BeginSlot),
+		                          Alignment);
+		void* Memory = FMemory::Malloc(DataOffset + EndOffset - BaseOffset,
+		                               Alignment);
+		auto* Block = new (Memory) FCoroutineLocalBlock{
+			nullptr, BeginSlot, EndSlot, BaseOffset, EndOffset, DataOffset};
+		std::uninitialized_value_construct_n(Block->Entries(),
+		                                     EndSlot - BeginSlot);
+		return Block;
+	}
+
+	FEntry* Entries() { return reinterpret_cast<FEntry*>(this + 1); }
+	FEntry& Entry(int32 Slot) { return Entries()[Slot - BeginSlot]; }
+
+	void* Value(uint32 Offset)
+	{
+		return reinterpret_cast<uint8*>(this) + DataOffset +
+		       (Offset - BaseOffset);
+	}
+};
+
+FCoroutineLocalSlot UE5Coro::Private::AllocateCoroutineLocalSlot(
+	size_t Size, size_t Alignment)
+{
+	UE::TUniqueLock Lock(GCoroutineLocalLock);
+	int32 Slot = GNumCoroutineLocalSlots.load(std::memory_order_relaxed);
+	checkf(Slot < TNumericLimits<int32>::Max(),
+	       TEXT("Too many TCoroutineLocal objects"));
+	uint64 Offset = Align<uint64>(
+		GCoroutineLocalSize.load(std::memory_order_relaxed), Alignment);
+	checkf(Offset + Size <= TNumericLimits<uint32>::Max(),
+	       TEXT("TCoroutineLocal objects are too large"));
+	GCoroutineLocalSize.store(static_cast<uint32>(Offset + Size),
+	                          std::memory_order_relaxed);
+	GCoroutineLocalAlignment.store(FMath::Max<uint32>(
+		GCoroutineLocalAlignment.load(std::memory_order_relaxed), Alignment),
+		std::memory_order_relaxed);
+	GNumCoroutineLocalSlots.store(Slot + 1, std::memory_order_release);
+	return {Slot, static_cast<uint32>(Offset)};
+}
 
 FWorldScope::FWorldScope(UWorld* World)
 	: World(World),
@@ -75,6 +159,17 @@ bool FPromiseExtras::IsComplete() const
 	return Completed->Wait(0, true);
 }
 
+bool FPromiseExtras::TryAddContinuation(FContinuationNode& Node)
+{
+	UE::TUniqueLock L(Lock);
+	if (IsComplete())
+		return false;
+	checkf(Promise,
+	       TEXT("Internal error: attaching continuation to a complete promise"));
+	Promise->AddContinuation(Node);
+	return true;
+}
+
 FPromise::FPromise(std::shared_ptr<FPromiseExtras> InExtras,
                    const TCHAR* PromiseType)
 	: Extras(std::move(InExtras))
@@ -114,11 +209,19 @@ FPromise::~FPromise()
 	// The coroutine is considered completed NOW
 	auto* ReturnValuePtr = std::exchange(Extras->ReturnValuePtr, nullptr);
 	Extras->Completed->Trigger(); // This prevents new continuations
+	Extras->bDone = true;
 	auto Completions = std::move(OnCompleted);
+	auto* Node = std::exchange(OnCompletedNodes, nullptr);
 	Extras->Lock.Unlock();
 
 	for (auto& Fn : Completions)
 		Fn(ReturnValuePtr);
+	while (Node)
+	{
+		auto* Next = Node->Next; // Fn may free Node
+		Node->Fn(Node, ReturnValuePtr);
+		Node = Next;
+	}
 }
 
 void FPromise::ResumeInternal(bool bBypassCancellationHolds)
@@ -161,6 +264,78 @@ FPromise& FPromise::Current()
 	return *GCurrentPromise;
 }
 
+void* FPromise::FindLocalValue(FCoroutineLocalSlot Slot) const
+{
+	// There's only one block unless slots were registered after it was made
+	for (auto* Block = Locals; Block; Block = Block->Next)
+		if (Slot.Index < Block->EndSlot) [[likely]]
+			return Block->Entry(Slot.Index).Destroy ? Block->Value(Slot.Offset)
+			                                        : nullptr;
+	return nullptr;
+}
+
+void* FPromise::ConstructLocal(FCoroutineLocalSlot Slot,
+                               void (*Construct)(void*),
+                               void (*Destroy)(void*))
+{
+	auto** Link = &Locals;
+	int32 EndSlot = 0;
+	uint32 EndOffset = 0;
+	for (; *Link && Slot.Index >= (*Link)->EndSlot; Link = &(*Link)->Next)
+	{
+		EndSlot = (*Link)->EndSlot;
+		EndOffset = (*Link)->EndOffset;
+	}
+	if (!*Link)
+		*Link = FCoroutineLocalBlock::Allocate(EndSlot, EndOffset);
+
+	// Construct might access other locals and allocate more blocks, which
+	// doesn't move this one. Only mark the value as constructed after it is.
+	auto* Block = *Link;
+	void* Value = Block->Value(Slot.Offset);
+	Construct(Value);
+	Block->Entry(Slot.Index) = {Destroy, Slot.Offset};
+	return Value;
+}
+
+void FPromise::ResetLocal(FCoroutineLocalSlot Slot)
+{
+	for (auto* Block = Locals; Block; Block = Block->Next)
+		if (Slot.Index < Block->EndSlot)
+		{
+			// The destructor might access other locals, clear the entry first
+			if (auto* Destroy = std::exchange(Block->Entry(Slot.Index).Destroy,
+			                                  nullptr))
+				Destroy(Block->Value(Slot.Offset));
+			return;
+		}
+}
+
+void FPromise::DestroyLocals()
+{
+	// Destructors might access other locals, including ones that are not
+	// constructed yet. These are destroyed by later passes.
+	for (bool bDestroyed = true; bDestroyed; )
+	{
+		bDestroyed = false;
+		for (auto* Block = Locals; Block; Block = Block->Next)
+			for (int32 i = Block->EndSlot - 1; i >= Block->BeginSlot; --i)
+			{
+				auto& Entry = Block->Entry(i);
+				if (auto* Destroy = std::exchange(Entry.Destroy, nullptr))
+				{
+					Destroy(Block->Value(Entry.Offset));
+					bDestroyed = true;
+				}
+			}
+	}
+	while (auto* Block = Locals)
+	{
+		Locals = Block->Next;
+		FMemory::Free(Block);
+	}
+}
+
 UE::FMutex& FPromise::GetLock()
 {
 	return Extras->Lock;
@@ -211,9 +386,21 @@ void FPromise::Cancel(bool bBypassCancellationHolds)
 	checkf(Extras->Lock.IsLocked(),
 	       TEXT("Internal error: unguarded cancellation"));
 	CancellationTracker.Cancel();
-	if (CancelableAwaiter && ShouldCancel(bBypassCancellationHolds))
+	if (!ShouldCancel(bBypassCancellationHolds))
+		return;
+
+	if (CancelableAwaiter)
+	{
+		// The awaiter might cancel other coroutines while this lock is held,
+		// which prevents those cancellations from being expedited on this thread
+		++GCancelableAwaiterDepth;
 		(**static_cast<void (**)(void*, FPromise&)>(CancelableAwaiter))(
 			CancelableAwaiter, *this);
+		verifyf(--GCancelableAwaiterDepth >= 0,
+		        TEXT("Internal error: cancellation tracking derailed"));
+	}
+	else
+		ExpediteCancellation();
 }
 
 bool FPromise::ShouldCancel(bool bBypassCancellationHolds) const
@@ -257,6 +444,14 @@ void FPromise::AddContinuation(std::function<void(void*)> Fn)
 	OnCompleted.push_back(std::move(Fn));
 }
 
+void FPromise::AddContinuation(FContinuationNode& Node)
+{
+	checkf(Extras->Lock.IsLocked(), TEXT("Internal error: lock not held"));
+	checkf(Node.Fn, TEXT("Internal error: adding empty node as continuation"));
+
+	Node.Next = std::exchange(OnCompletedNodes, &Node);
+}
+
 void FPromise::unhandled_exception()
 {
 #if PLATFORM_EXCEPTIONS_DISABLED
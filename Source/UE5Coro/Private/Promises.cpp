@@ -29,6 +29,8 @@
 // OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include "AdmissionControl.h"
+#include "GameThreadInbox.h"
 #include "LatentActions.h"
 #include "LatentExitReason.h"
 #include "UE5Coro/LatentAwaiter.h"
@@ -36,6 +38,14 @@
 
 using namespace UE5Coro::Private;
 
+namespace
+{
+// Latent coroutines that were canceled while possibly awaiting a latent awaiter
+UE::FMutex GExpeditedLock;
+TArray<std::shared_ptr<FPromiseExtras>> GExpedited;
+std::atomic<bool> GHasExpedited = false;
+}
+
 namespace UE5Coro::Private
 {
 class [[nodiscard]] FPendingLatentCoroutine final : public FPendingLatentAction
@@ -46,6 +56,7 @@ class [[nodiscard]] FPendingLatentCoroutine final : public FPendingLatentAction
 	// to synchronize and the lock is not used to access Extras->Promise.
 	std::shared_ptr<FPromiseExtras> Extras;
 	bool bTriggerLink = false;
+	bool bPolling = false;
 	FLatentActionInfo LatentInfo;
 	FLatentAwaiter CurrentAwaiter; // latent->latent await fast path
 
@@ -101,7 +112,14 @@ public:
 		checkf(IsValid(LatentPromise->GetWorld()),
 		       TEXT("Internal error: latent coroutine's home world was lost"));
 		FWorldScope WorldScope(LatentPromise->GetWorld());
-		if (CurrentAwaiter.IsValid() && CurrentAwaiter.ShouldResume())
+		bool bResume = false;
+		if (CurrentAwaiter.IsValid())
+		{
+			// Expedited cancellations can't destroy the awaiter while it's used
+			TGuardValue _(bPolling, true);
+			bResume = CurrentAwaiter.ShouldResume();
+		}
+		if (bResume)
 		{
 			CurrentAwaiter.Clear();
 			// This might set the awaiter for next time
@@ -168,6 +186,22 @@ public:
 
 		CurrentAwaiter = Awaiter;
 	}
+
+	void ExpediteCancellation()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: expected expedited cancellation on the GT"));
+		// If the coroutine is running, or the awaiter is being polled right
+		// now, the cancellation will be processed when that's done
+		if (bPolling || !CurrentAwaiter.IsValid())
+			return;
+
+		auto* LatentPromise = static_cast<FLatentPromise*>(Extras->Promise);
+		CurrentAwaiter.Clear();
+		// The awaiter is disarmed, this will destroy the coroutine.
+		// The next UpdateOperation will see the missing promise and finish.
+		LatentPromise->Resume();
+	}
 };
 }
 
@@ -255,7 +289,7 @@ void FLatentPromise::ThreadSafeDestroy()
 	// Latent coroutines always end on the game thread by definition
 	if (!IsInGameThread())
 	{
-		AsyncTask(ENamedThreads::GameThread, [this] { ThreadSafeDestroy(); });
+		FGameThreadInbox::Get().Destroy(*this);
 		return;
 	}
 
@@ -292,6 +326,45 @@ void FLatentPromise::Resume()
 	ResumeInternal(!LatentAction);
 }
 
+void FLatentPromise::ExpediteCancellation()
+{
+	checkf(Extras->Lock.IsLocked(), TEXT("Internal error: lock not held"));
+	// Attached coroutines are either running on the game thread, or awaiting
+	// a FLatentAwaiter that doesn't know about cancellations.
+	// The game thread will sort out which one it is.
+	if (LatentAction && IsOnGameThread())
+	{
+		UE::TUniqueLock Lock(GExpeditedLock);
+		GExpedited.Add(Extras);
+		GHasExpedited = true;
+	}
+}
+
+void FLatentPromise::ProcessExpeditedCancellations()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected to be called on the game thread"));
+	if (!GHasExpedited) [[likely]]
+		return;
+
+	TArray<std::shared_ptr<FPromiseExtras>> Expedited;
+	{
+		UE::TUniqueLock Lock(GExpeditedLock);
+		Expedited = std::move(GExpedited);
+		GHasExpedited = false;
+	}
+
+	// Latent promises are only destroyed on the game thread, so the promises
+	// cannot disappear without this thread's involvement. Processing one entry
+	// might destroy other coroutines, hence the checks before every call.
+	for (auto& Extras : Expedited)
+		if (auto* Promise = static_cast<FLatentPromise*>(Extras->Promise))
+			if (auto* Pending = static_cast<FPendingLatentCoroutine*>(
+			        Promise->LatentAction);
+			    Pending && Promise->ShouldCancel(false))
+				Pending->ExpediteCancellation();
+}
+
 void FLatentPromise::LatentActionDestroyed()
 {
 	UE::TUniqueLock Lock(Extras->Lock);
@@ -411,8 +484,16 @@ FInitialSuspend FLatentPromise::initial_suspend()
 	// FForceLatentCoroutine uses UUE5CoroSubsystem as a helper callback target.
 	LAM.AddNewAction(Target, LatentInfo.UUID, Pending);
 
-	// Let the coroutine start immediately on its calling thread
-	return {FInitialSuspend::Resume};
+	switch (FAdmissionControl::Get().Admit(*this, Extras, Target))
+	{
+		// FAdmissionControl will resume the coroutine when it's admitted.
+		// The latent action can cancel it in the meantime.
+		case FAdmissionControl::Queued: return {FInitialSuspend::Defer};
+		// The latent action will see the missing promise, and finish
+		case FAdmissionControl::Rejected: return {FInitialSuspend::Fail};
+		// Let the coroutine start immediately on its calling thread
+		default: return {FInitialSuspend::Resume};
+	}
 }
 
 FLatentFinalSuspend FLatentPromise::final_suspend() noexcept
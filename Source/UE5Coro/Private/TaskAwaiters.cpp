@@ -35,5 +35,6 @@ using namespace UE5Coro::Private;
 
 void FTaskAwaiter::Suspend(FPromise& Promise)
 {
-	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); });
+	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); }, Priority,
+	                  ExtendedPriority);
 }
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/Threading.h"
+#include "Async/Async.h"
 #include "UE5Coro/AsyncAwaiter.h"
 
 using namespace UE5Coro;
@@ -37,42 +38,103 @@ using namespace UE5Coro::Private;
 
 namespace
 {
-void SuspendCore(void* This, FPromise& Promise, UE::FMutex& Lock,
-                 std::forward_list<FPromise*>& List)
+void SuspendCore(void* This, FWaitNode& Node, FPromise& Promise,
+                 UE::FMutex& Lock, FWaitQueue& Queue)
 {
 	UE::TUniqueLock L(Promise.GetLock()); // The promise's lock
 	checkf(Lock.IsLocked(), // The awaiter's lock
 	       TEXT("Internal error: unguarded suspension"));
 	if (Promise.RegisterCancelableAwaiter(This))
-		List.push_front(&Promise);
+	{
+		Node.Promise = &Promise;
+		Queue.PushBack(Node);
+	}
 	else
 		FAsyncYieldAwaiter::Suspend(Promise);
 	Lock.Unlock();
 }
 
-void CancelCore(FPromise& Promise, UE::FMutex& Lock,
-                std::forward_list<FPromise*>& List)
+void CancelCore(FWaitNode& Node, FPromise& Promise, UE::FMutex& Lock,
+                FWaitQueue& Queue)
 {
 	checkf(Promise.GetLock().IsLocked(), // The promise's lock
 	       TEXT("Internal error: expected guarded cancellation"));
 	UE::TUniqueLock L(Lock); // The awaiter's lock
-	for (auto i = List.before_begin();;)
+	// If the node is not queued, it was already taken by TryResume, which will
+	// finish the cancellation after this function releases the promise's lock
+	if (Queue.Remove(Node))
+		// Calling Resume() synchronously from Cancel() would complicate things
+		FAsyncYieldAwaiter::Suspend(Promise);
+}
+
+// Called on promises whose node was taken out of its queue, without holding
+// the queue's lock. Nothing else can resume the coroutine at this point.
+bool TryResume(FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<true>())
 	{
-		auto Before = i++;
-		if (i == List.end())
-			// This is OK, TryResumeAll might have cleared the list
-			break;
-		else if (*i == &Promise)
-		{
-			List.erase_after(Before);
-			break;
-		}
+		Promise.Resume();
+		return true;
 	}
-	checkfSlow(std::ranges::find(List, &Promise) == List.end(),
-	           TEXT("Internal error: multiple promises found"));
-	// Calling Resume() synchronously from Cancel() would complicate things
+	// CancelCore ran, but it found the node already gone
 	FAsyncYieldAwaiter::Suspend(Promise);
+	return false;
 }
+
+bool TryResume(FWaitNode& Node)
+{
+	if (auto* Callback = Node.Callback)
+		return Callback(Node, false);
+	return TryResume(*Node.Promise);
+}
+
+// Like TryResume, but the promise is added to Promises instead of resuming it
+bool TryTake(FWaitNode& Node, TArray<FPromise*>& Promises)
+{
+	if (auto* Callback = Node.Callback)
+		return Callback(Node, true);
+	auto& Promise = *Node.Promise;
+	if (Promise.UnregisterCancelableAwaiter<true>())
+	{
+		Promises.Add(&Promise);
+		return true;
+	}
+	FAsyncYieldAwaiter::Suspend(Promise);
+	return false;
+}
+
+// Resumes every promise on the task graph, using at most one task per worker
+void DispatchResumes(const TArray<FPromise*>& Promises)
+{
+	int NumTasks = FMath::Clamp(
+		FTaskGraphInterface::Get().GetNumWorkerThreads(), 1, Promises.Num());
+	for (int i = 0; i < NumTasks; ++i)
+	{
+		TArray<FPromise*> Chunk;
+		for (int j = i; j < Promises.Num(); j += NumTasks)
+			Chunk.Add(Promises[j]);
+		AsyncTask(ENamedThreads::AnyThread, [Chunk = std::move(Chunk)]
+		{
+			for (auto* Promise : Chunk)
+				Promise->Resume();
+		});
+	}
+}
+
+// Resumes a list of nodes returned by FWaitQueue::TakeAll
+void TryResumeAll(FWaitNode* Node)
+{
+	while (Node)
+	{
+		auto* Promise = Node->Promise;
+		Node = Node->Next; // Resuming the promise might destroy its node
+		TryResume(*Promise);
+	}
+}
+
+// Barrier state layout
+constexpr uint64 PhaseOne = uint64(1) << 32;
+constexpr uint64 CountMask = PhaseOne - 1;
 }
 
 FAwaitableEvent::FAwaitableEvent(EEventMode Mode, bool bInitialState)
@@ -86,8 +148,7 @@ FAwaitableEvent::FAwaitableEvent(EEventMode Mode, bool bInitialState)
 FAwaitableEvent::~FAwaitableEvent()
 {
 	UE::TUniqueLock L(Lock);
-	checkf(AwaitingPromises.empty(),
-	       TEXT("Event destroyed with active awaiters"));
+	checkf(Waiters.IsEmpty(), TEXT("Event destroyed with active awaiters"));
 }
 #endif
 
@@ -100,18 +161,7 @@ void FAwaitableEvent::Trigger()
 		TryResumeAll();
 	}
 	else
-retry:
-		if (!AwaitingPromises.empty())
-		{
-			if (!TryResumeOne()) // AutoReset: don't set bActive
-				goto retry;
-			// TryResumeOne unlocks the lock before returning true
-		}
-		else
-		{
-			bActive = true;
-			Lock.Unlock();
-		}
+		TryResumeOne();
 }
 
 void FAwaitableEvent::Reset()
@@ -130,36 +180,36 @@ FEventAwaiter FAwaitableEvent::operator co_await()
 	return FEventAwaiter(*this);
 }
 
-bool FAwaitableEvent::TryResumeOne()
+void FAwaitableEvent::TryResumeOne()
 {
 	checkf(Lock.IsLocked(), TEXT("Internal error: resuming without lock"));
-	checkf(!AwaitingPromises.empty(),
-	       TEXT("Internal error: attempting to resume nothing"));
-	auto* Promise = AwaitingPromises.front();
-	AwaitingPromises.pop_front();
-	if (Promise->UnregisterCancelableAwaiter<true>())
+	// AutoReset: resume the oldest awaiter, or become active if there are none
+	while (auto* Node = Waiters.PopFront())
 	{
 		Lock.Unlock();
-		Promise->Resume();
-		return true;
+		if (TryResume(*Node))
+			return;
+		Lock.Lock(); // That one was getting canceled, try another
 	}
-	else
-		// This promise is getting canceled; try another, still holding the lock
-		return false;
+	bActive = true;
+	Lock.Unlock();
 }
 
 void FAwaitableEvent::TryResumeAll()
 {
 	checkf(Lock.IsLocked(), TEXT("Internal error: resuming without lock"));
 
-	// Start a new list to make sure every current awaiter gets resumed,
+	// Take every current awaiter to make sure they all get resumed,
 	// even if the event is reset during one of the Resume() calls
-	auto List = std::exchange(AwaitingPromises, {});
+	auto* Node = Waiters.TakeAll();
 	Lock.Unlock();
 
-	for (auto* Promise : List)
-		if (Promise->UnregisterCancelableAwaiter<true>())
-			Promise->Resume();
+	while (Node)
+	{
+		auto& Current = *Node;
+		Node = Node->Next; // Resuming the promise might destroy its node
+		TryResume(Current);
+	}
 }
 
 bool FEventAwaiter::await_ready() noexcept
@@ -180,20 +230,22 @@ bool FEventAwaiter::await_ready() noexcept
 void FEventAwaiter::Suspend(FPromise& Promise)
 {
 	checkf(!Event.bActive, TEXT("Internal error: suspending with active event"));
-	SuspendCore(this, Promise, Event.Lock, Event.AwaitingPromises);
+	SuspendCore(this, Node, Promise, Event.Lock, Event.Waiters);
 }
 
 void FEventAwaiter::Cancel(void* This, FPromise& Promise)
 {
 	if (Promise.UnregisterCancelableAwaiter<false>())
 	{
-		auto& Event = static_cast<FEventAwaiter*>(This)->Event;
-		CancelCore(Promise, Event.Lock, Event.AwaitingPromises);
+		auto* Awaiter = static_cast<FEventAwaiter*>(This);
+		auto& Event = Awaiter->Event;
+		CancelCore(Awaiter->Node, Promise, Event.Lock, Event.Waiters);
 	}
 }
 
-FAwaitableSemaphore::FAwaitableSemaphore(int Capacity, int InitialCount)
-	: Capacity(Capacity), Count(InitialCount)
+FAwaitableSemaphore::FAwaitableSemaphore(int Capacity, int InitialCount,
+                                         ESemaphoreFlags Flags)
+	: Capacity(Capacity), Count(InitialCount), Flags(Flags)
 {
 	checkf(Capacity > 0 && InitialCount >= 0 && InitialCount <= Capacity,
 	       TEXT("Initial semaphore values out of range"));
@@ -203,7 +255,7 @@ FAwaitableSemaphore::FAwaitableSemaphore(int Capacity, int InitialCount)
 FAwaitableSemaphore::~FAwaitableSemaphore()
 {
 	UE::TUniqueLock L(Lock);
-	checkf(AwaitingPromises.empty(),
+	checkf(Waiters.IsEmpty(),
 	       TEXT("Semaphore destroyed with active awaiters"));
 }
 #endif
@@ -225,16 +277,40 @@ FSemaphoreAwaiter FAwaitableSemaphore::operator co_await()
 void FAwaitableSemaphore::TryResumeAll()
 {
 	checkf(Lock.IsLocked(), TEXT("Internal error: resuming without lock held"));
-	while (!AwaitingPromises.empty() && Count > 0)
+	bool bHandoff = EnumHasAnyFlags(Flags, ESemaphoreFlags::Handoff);
+	bool bDispatch = EnumHasAnyFlags(Flags, ESemaphoreFlags::DispatchWakes);
+	while (Count > 0 && !Waiters.IsEmpty())
 	{
-		auto* Promise = AwaitingPromises.front();
-		AwaitingPromises.pop_front();
-		if (!Promise->UnregisterCancelableAwaiter<true>())
-			continue; // This promise is getting canceled, try another
-		verifyf(--Count >= 0, TEXT("Internal error: semaphore went negative"));
+		// Without handoff, the lock is released after every awaiter, and the
+		// remaining count is up for grabs while the coroutine is running.
+		// Dispatched coroutines don't run here, they're all taken at once.
+		FWaitQueue Batch;
+		do
+		{
+			Batch.PushBack(*Waiters.PopFront());
+			verifyf(--Count >= 0,
+			        TEXT("Internal error: semaphore went negative"));
+		} while ((bHandoff || bDispatch) && Count > 0 && !Waiters.IsEmpty());
+		auto* Node = Batch.TakeAll(); // Cancellations will ignore these nodes
 		Lock.Unlock();
-		Promise->Resume(); // The coroutine might want the lock
+
+		int Returned = 0;
+		TArray<FPromise*> Dispatched;
+		while (Node)
+		{
+			auto& Current = *Node;
+			Node = Node->Next; // Resuming the promise might destroy its node
+			// Resumed coroutines might want the lock
+			bool bTaken = bDispatch ? TryTake(Current, Dispatched)
+			                        : TryResume(Current);
+			if (!bTaken)
+				++Returned; // This awaiter was getting canceled
+		}
+		if (!Dispatched.IsEmpty())
+			DispatchResumes(Dispatched);
+
 		Lock.Lock();
+		Count += Returned;
 	}
 	Lock.Unlock();
 }
@@ -255,14 +331,760 @@ bool FSemaphoreAwaiter::await_ready()
 
 void FSemaphoreAwaiter::Suspend(FPromise& Promise)
 {
-	SuspendCore(this, Promise, Semaphore.Lock, Semaphore.AwaitingPromises);
+	SuspendCore(this, Node, Promise, Semaphore.Lock, Semaphore.Waiters);
 }
 
 void FSemaphoreAwaiter::Cancel(void* This, FPromise& Promise)
 {
 	if (Promise.UnregisterCancelableAwaiter<false>())
 	{
-		auto& Semaphore = static_cast<FSemaphoreAwaiter*>(This)->Semaphore;
-		CancelCore(Promise, Semaphore.Lock, Semaphore.AwaitingPromises);
+		auto* Awaiter = static_cast<FSemaphoreAwaiter*>(This);
+		auto& Semaphore = Awaiter->Semaphore;
+		CancelCore(Awaiter->Node, Promise, Semaphore.Lock, Semaphore.Waiters);
+	}
+}
+
+FAwaitableMutex::FGuard& FAwaitableMutex::FGuard::operator=(
+	FGuard&& Other) noexcept
+{
+	if (this != &Other)
+	{
+		Unlock();
+		Mutex = std::exchange(Other.Mutex, nullptr);
+	}
+	return *this;
+}
+
+FAwaitableMutex::FGuard::~FGuard()
+{
+	Unlock();
+}
+
+void FAwaitableMutex::FGuard::Unlock()
+{
+	if (auto* LockedMutex = std::exchange(Mutex, nullptr))
+		LockedMutex->Unlock();
+}
+
+#if UE5CORO_DEBUG
+FAwaitableMutex::~FAwaitableMutex()
+{
+	checkf(State.load() == 0 || State.load() == Contended,
+	       TEXT("Mutex destroyed while locked"));
+	UE::TUniqueLock L(QueueLock);
+	checkf(Waiters.IsEmpty(), TEXT("Mutex destroyed with active awaiters"));
+}
+#endif
+
+FMutexLockAwaiter FAwaitableMutex::Lock() noexcept
+{
+	return FMutexLockAwaiter(*this);
+}
+
+FAwaitableMutex::FGuard FAwaitableMutex::TryLock() noexcept
+{
+	// A stale Contended flag makes this fail spuriously, which is allowed
+	return FGuard(TryLockFast() ? this : nullptr);
+}
+
+bool FAwaitableMutex::TryLockFast() noexcept
+{
+	uint8 Expected = 0;
+	return State.compare_exchange_strong(Expected, Locked,
+	                                     std::memory_order_acquire,
+	                                     std::memory_order_relaxed);
+}
+
+void FAwaitableMutex::Unlock()
+{
+	uint8 Expected = Locked;
+	if (State.compare_exchange_strong(Expected, 0, std::memory_order_release,
+	                                  std::memory_order_relaxed))
+		return;
+
+	checkf(Expected & Locked, TEXT("Unlocking a mutex that is not locked"));
+	QueueLock.Lock();
+	while (auto* Node = Waiters.PopFront())
+	{
+		// Hand ownership over directly, the mutex remains locked throughout.
+		// Other threads only change State while holding QueueLock, or from 0.
+		if (Waiters.IsEmpty())
+			State.store(Locked, std::memory_order_relaxed);
+		QueueLock.Unlock();
+
+		auto& Promise = *Node->Promise;
+		if (Promise.UnregisterCancelableAwaiter<true>())
+		{
+			static_cast<FLockWaitNode*>(Node)->bAcquired = true;
+			Promise.Resume();
+			return;
+		}
+		// CancelCore ran, but it found the node already gone.
+		// Finish the cancellation, and try the next awaiter.
+		FAsyncYieldAwaiter::Suspend(Promise);
+		QueueLock.Lock();
+	}
+	State.store(0, std::memory_order_release);
+	QueueLock.Unlock();
+}
+
+FMutexLockAwaiter::~FMutexLockAwaiter()
+{
+	// The lock was handed over, but the coroutine was destroyed by a
+	// cancellation that arrived before it could resume and take ownership
+	if (Node.bAcquired) [[unlikely]]
+		Mutex.Unlock();
+}
+
+bool FMutexLockAwaiter::await_ready()
+{
+	if (Mutex.TryLockFast()) [[likely]]
+	{
+		Node.bAcquired = true;
+		return true;
+	}
+
+	Mutex.QueueLock.Lock();
+	for (auto Value = Mutex.State.load(std::memory_order_relaxed);;)
+		if (!(Value & FAwaitableMutex::Locked))
+		{
+			if (Mutex.State.compare_exchange_weak(
+				Value, Value | FAwaitableMutex::Locked,
+				std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				Mutex.QueueLock.Unlock();
+				Node.bAcquired = true;
+				return true;
+			}
+		}
+		// Make Unlock() take the slow path, and look at the queue
+		else if ((Value & FAwaitableMutex::Contended) ||
+		         Mutex.State.compare_exchange_weak(
+			         Value, Value | FAwaitableMutex::Contended,
+			         std::memory_order_relaxed))
+			return false; // Leave QueueLock locked
+}
+
+void FMutexLockAwaiter::Suspend(FPromise& Promise)
+{
+	SuspendCore(this, Node, Promise, Mutex.QueueLock, Mutex.Waiters);
+}
+
+FAwaitableMutex::FGuard FMutexLockAwaiter::await_resume() noexcept
+{
+	// This is false if the coroutine was canceled before it got the lock, but
+	// it's still running due to FCancellationGuard
+	bool bAcquired = std::exchange(Node.bAcquired, false);
+	return FAwaitableMutex::FGuard(bAcquired ? &Mutex : nullptr);
+}
+
+void FMutexLockAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FMutexLockAwaiter*>(This);
+		auto& Mutex = Awaiter->Mutex;
+		CancelCore(Awaiter->Node, Promise, Mutex.QueueLock, Mutex.Waiters);
+	}
+}
+
+FAwaitableRWLock::FGuard& FAwaitableRWLock::FGuard::operator=(
+	FGuard&& Other) noexcept
+{
+	if (this != &Other)
+	{
+		Unlock();
+		Lock = std::exchange(Other.Lock, nullptr);
+		bWrite = Other.bWrite;
+	}
+	return *this;
+}
+
+FAwaitableRWLock::FGuard::~FGuard()
+{
+	Unlock();
+}
+
+void FAwaitableRWLock::FGuard::Unlock()
+{
+	if (auto* LockedLock = std::exchange(Lock, nullptr))
+	{
+		if (bWrite)
+			LockedLock->WriteUnlock();
+		else
+			LockedLock->ReadUnlock();
+	}
+}
+
+FAwaitableRWLock::FAwaitableRWLock(ERWLockPolicy Policy) noexcept
+	: Policy(Policy)
+{
+	checkf(Policy == ERWLockPolicy::PreferWriters ||
+	       Policy == ERWLockPolicy::PreferReaders,
+	       TEXT("Invalid RW lock policy"));
+}
+
+#if UE5CORO_DEBUG
+FAwaitableRWLock::~FAwaitableRWLock()
+{
+	checkf((State.load() & ~Contended) == 0,
+	       TEXT("RW lock destroyed while locked"));
+	UE::TUniqueLock L(QueueLock);
+	checkf(ReadWaiters.IsEmpty() && WriteWaiters.IsEmpty(),
+	       TEXT("RW lock destroyed with active awaiters"));
+}
+#endif
+
+FRWLockAwaiter FAwaitableRWLock::ReadLock() noexcept
+{
+	return FRWLockAwaiter(*this, false);
+}
+
+FRWLockAwaiter FAwaitableRWLock::WriteLock() noexcept
+{
+	return FRWLockAwaiter(*this, true);
+}
+
+FAwaitableRWLock::FGuard FAwaitableRWLock::TryReadLock() noexcept
+{
+	// A stale Contended flag makes these fail spuriously, which is allowed
+	return FGuard(TryReadFast() ? this : nullptr, false);
+}
+
+FAwaitableRWLock::FGuard FAwaitableRWLock::TryWriteLock() noexcept
+{
+	return FGuard(TryWriteFast() ? this : nullptr, true);
+}
+
+bool FAwaitableRWLock::TryReadFast() noexcept
+{
+	// Preferring writers means that queued awaiters must be looked at first
+	uint32 Blockers = Policy == ERWLockPolicy::PreferWriters
+		                  ? Writer | Contended : Writer;
+	for (auto Value = State.load(std::memory_order_relaxed); !(Value & Blockers);)
+	{
+		checkf((Value & Readers) != Readers, TEXT("Too many readers"));
+		if (State.compare_exchange_weak(Value, Value + 1,
+		                                std::memory_order_acquire,
+		                                std::memory_order_relaxed))
+			return true;
+	}
+	return false;
+}
+
+bool FAwaitableRWLock::TryWriteFast() noexcept
+{
+	uint32 Expected = 0;
+	return State.compare_exchange_strong(Expected, Writer,
+	                                     std::memory_order_acquire,
+	                                     std::memory_order_relaxed);
+}
+
+void FAwaitableRWLock::ReadUnlock()
+{
+	auto Value = State.fetch_sub(1, std::memory_order_release) - 1;
+	checkf((Value & Readers) != Readers,
+	       TEXT("Read unlocking a RW lock that is not read locked"));
+	// The last reader is responsible for waking writers up
+	if (Value == Contended)
+	{
+		QueueLock.Lock();
+		WakeWaiters();
+	}
+}
+
+void FAwaitableRWLock::WriteUnlock()
+{
+	uint32 Expected = Writer;
+	if (State.compare_exchange_strong(Expected, 0, std::memory_order_release,
+	                                  std::memory_order_relaxed))
+		return;
+
+	checkf(Expected & Writer,
+	       TEXT("Write unlocking a RW lock that is not write locked"));
+	QueueLock.Lock();
+	State.fetch_and(~Writer, std::memory_order_release);
+	WakeWaiters();
+}
+
+// Called with QueueLock held, returns with it released.
+// Nobody can become a writer outside this lock while Contended is set, readers
+// might come and go on the fast path if they're preferred.
+void FAwaitableRWLock::WakeWaiters()
+{
+	FWaitNode* Granted = nullptr;
+	bool bGrantedWrite = false;
+	for (auto Value = State.load(std::memory_order_relaxed);;)
+	{
+		if (Value & Writer)
+			break; // The lock was handed over or taken while unlocked
+
+		if (!WriteWaiters.IsEmpty() &&
+		    (Policy == ERWLockPolicy::PreferWriters || ReadWaiters.IsEmpty()))
+		{
+			if (Value & Readers)
+				break; // The last reader will come back here
+			// Keep Contended set, a stale flag only costs a slow unlock
+			if (State.compare_exchange_weak(Value, Writer | Contended,
+			                                std::memory_order_acquire,
+			                                std::memory_order_relaxed))
+			{
+				Granted = WriteWaiters.PopFront();
+				bGrantedWrite = true;
+				break;
+			}
+		}
+		else if (!ReadWaiters.IsEmpty())
+		{
+			// Take every reader while the lock is held, so that cancellations
+			// see them as already gone
+			uint32 Count = 0;
+			Granted = ReadWaiters.TakeAll();
+			for (auto* Node = Granted; Node; Node = Node->Next)
+				++Count;
+			uint32 Mask = WriteWaiters.IsEmpty() ? ~Contended : ~0u;
+			while (!State.compare_exchange_weak(Value, (Value + Count) & Mask,
+			                                    std::memory_order_acquire,
+			                                    std::memory_order_relaxed))
+				checkf(!(Value & Writer),
+				       TEXT("Internal error: unexpected RW lock writer"));
+			break;
+		}
+		else if (State.compare_exchange_weak(Value, Value & ~Contended,
+		                                     std::memory_order_relaxed))
+			break; // Nothing is waiting
+	}
+	QueueLock.Unlock();
+
+	while (auto* Node = Granted)
+	{
+		Granted = Node->Next; // Node might be gone after Resume()
+		auto& Promise = *Node->Promise;
+		if (Promise.UnregisterCancelableAwaiter<true>())
+		{
+			static_cast<FLockWaitNode*>(Node)->bAcquired = true;
+			Promise.Resume();
+		}
+		else
+		{
+			// CancelCore ran, but it found the node already gone.
+			// Finish the cancellation, and give up what it was given.
+			FAsyncYieldAwaiter::Suspend(Promise);
+			if (bGrantedWrite)
+				WriteUnlock();
+			else
+				ReadUnlock();
+		}
+	}
+}
+
+FRWLockAwaiter::~FRWLockAwaiter()
+{
+	// See ~FMutexLockAwaiter
+	if (Node.bAcquired) [[unlikely]]
+	{
+		if (bWrite)
+			Lock.WriteUnlock();
+		else
+			Lock.ReadUnlock();
+	}
+}
+
+bool FRWLockAwaiter::await_ready()
+{
+	if (bWrite ? Lock.TryWriteFast() : Lock.TryReadFast()) [[likely]]
+	{
+		Node.bAcquired = true;
+		return true;
+	}
+
+	Lock.QueueLock.Lock();
+	for (auto Value = Lock.State.load(std::memory_order_relaxed);;)
+	{
+		bool bIdle = Lock.ReadWaiters.IsEmpty() && Lock.WriteWaiters.IsEmpty();
+		bool bAvailable;
+		if (bWrite)
+			bAvailable = bIdle && !(Value & ~FAwaitableRWLock::Contended);
+		else
+			bAvailable = !(Value & FAwaitableRWLock::Writer) &&
+			             (Lock.Policy == ERWLockPolicy::PreferReaders ||
+			              Lock.WriteWaiters.IsEmpty());
+
+		if (bAvailable)
+		{
+			uint32 NewValue = bWrite ? Value | FAwaitableRWLock::Writer
+			                         : Value + 1;
+			if (bIdle) // Clear a stale flag
+				NewValue &= ~FAwaitableRWLock::Contended;
+			if (Lock.State.compare_exchange_weak(Value, NewValue,
+			                                     std::memory_order_acquire,
+			                                     std::memory_order_relaxed))
+			{
+				Lock.QueueLock.Unlock();
+				Node.bAcquired = true;
+				return true;
+			}
+		}
+		// Make unlocking take the slow path, and look at the queues
+		else if ((Value & FAwaitableRWLock::Contended) ||
+		         Lock.State.compare_exchange_weak(
+			         Value, Value | FAwaitableRWLock::Contended,
+			         std::memory_order_relaxed))
+			return false; // Leave QueueLock locked
+	}
+}
+
+void FRWLockAwaiter::Suspend(FPromise& Promise)
+{
+	SuspendCore(this, Node, Promise, Lock.QueueLock, GetQueue());
+}
+
+FAwaitableRWLock::FGuard FRWLockAwaiter::await_resume() noexcept
+{
+	// This is false if the coroutine was canceled before it got the lock, but
+	// it's still running due to FCancellationGuard
+	bool bAcquired = std::exchange(Node.bAcquired, false);
+	return FAwaitableRWLock::FGuard(bAcquired ? &Lock : nullptr, bWrite);
+}
+
+FWaitQueue& FRWLockAwaiter::GetQueue() const noexcept
+{
+	return bWrite ? Lock.WriteWaiters : Lock.ReadWaiters;
+}
+
+void FRWLockAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FRWLockAwaiter*>(This);
+		CancelCore(Awaiter->Node, Promise, Awaiter->Lock.QueueLock,
+		           Awaiter->GetQueue());
+	}
+}
+
+FAwaitableLatch::FAwaitableLatch(int Count)
+	: Count(Count)
+{
+	checkf(Count >= 0, TEXT("Invalid latch count"));
+}
+
+#if UE5CORO_DEBUG
+FAwaitableLatch::~FAwaitableLatch()
+{
+	UE::TUniqueLock L(Lock);
+	checkf(Waiters.IsEmpty(), TEXT("Latch destroyed with active awaiters"));
+}
+#endif
+
+void FAwaitableLatch::CountDown(int InCount)
+{
+	checkf(InCount >= 0, TEXT("Invalid count"));
+	int Old = Count.fetch_sub(InCount, std::memory_order_acq_rel);
+	checkf(Old >= InCount, TEXT("Latch counted down below zero"));
+	if (Old != InCount || InCount == 0)
+		return;
+
+	// Awaiters check the count with the lock held, there's no need to hold it
+	// while the count reaches zero
+	Lock.Lock();
+	auto* Node = Waiters.TakeAll();
+	Lock.Unlock();
+	TryResumeAll(Node);
+}
+
+bool FAwaitableLatch::TryWait() const noexcept
+{
+	return Count.load(std::memory_order_acquire) == 0;
+}
+
+FLatchAwaiter FAwaitableLatch::ArriveAndWait(int InCount)
+{
+	CountDown(InCount);
+	return FLatchAwaiter(*this);
+}
+
+FLatchAwaiter FAwaitableLatch::operator co_await()
+{
+	return FLatchAwaiter(*this);
+}
+
+bool FLatchAwaiter::await_ready()
+{
+	if (Latch.TryWait())
+		return true;
+	Latch.Lock.Lock();
+	if (Latch.TryWait())
+	{
+		Latch.Lock.Unlock();
+		return true;
+	}
+	return false; // Leave it locked
+}
+
+void FLatchAwaiter::Suspend(FPromise& Promise)
+{
+	SuspendCore(this, Node, Promise, Latch.Lock, Latch.Waiters);
+}
+
+void FLatchAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FLatchAwaiter*>(This);
+		auto& Latch = Awaiter->Latch;
+		CancelCore(Awaiter->Node, Promise, Latch.Lock, Latch.Waiters);
+	}
+}
+
+FAwaitableBarrier::FAwaitableBarrier(int NumParticipants,
+                                     std::function<void()> OnPhaseCompleted)
+	: State(NumParticipants), NumParticipants(NumParticipants),
+	  OnPhaseCompleted(std::move(OnPhaseCompleted))
+{
+	checkf(NumParticipants > 0, TEXT("Invalid participant count"));
+}
+
+#if UE5CORO_DEBUG
+FAwaitableBarrier::~FAwaitableBarrier()
+{
+	UE::TUniqueLock L(Lock);
+	checkf(Waiters.IsEmpty(), TEXT("Barrier destroyed with active awaiters"));
+}
+#endif
+
+FBarrierAwaiter FAwaitableBarrier::ArriveAndWait()
+{
+	return FBarrierAwaiter(*this);
+}
+
+void FAwaitableBarrier::Arrive()
+{
+	uint32 Phase;
+	(void)ArriveCore(Phase);
+}
+
+void FAwaitableBarrier::ArriveAndDrop()
+{
+	{
+		UE::TUniqueLock L(Lock);
+		checkf(NumParticipants > 0, TEXT("No participants left to drop"));
+		--NumParticipants; // Only read when the next phase begins
+	}
+	Arrive();
+}
+
+uint32 FAwaitableBarrier::GetPhase() const noexcept
+{
+	return static_cast<uint32>(State.load(std::memory_order_acquire) >> 32);
+}
+
+bool FAwaitableBarrier::ArriveCore(uint32& Phase)
+{
+	uint64 Old = State.fetch_sub(1, std::memory_order_acq_rel);
+	checkf(Old & CountMask, TEXT("Too many arrivals at barrier"));
+	Phase = static_cast<uint32>(Old >> 32);
+	if ((Old & CountMask) != 1)
+		return false;
+
+	// Every participant has arrived, nobody else can change State until the
+	// next phase begins
+	if (OnPhaseCompleted)
+		OnPhaseCompleted();
+	Lock.Lock();
+	State.store(((Old & ~CountMask) + PhaseOne) | NumParticipants,
+	            std::memory_order_release);
+	auto* Node = Waiters.TakeAll();
+	Lock.Unlock();
+	TryResumeAll(Node);
+	return true;
+}
+
+bool FBarrierAwaiter::await_ready()
+{
+	uint32 Phase;
+	if (Barrier.ArriveCore(Phase))
+		return true; // This was the last arrival
+
+	Barrier.Lock.Lock();
+	// The phase might have completed between arriving and locking
+	if (Barrier.GetPhase() != Phase)
+	{
+		Barrier.Lock.Unlock();
+		return true;
+	}
+	return false; // Leave it locked
+}
+
+void FBarrierAwaiter::Suspend(FPromise& Promise)
+{
+	SuspendCore(this, Node, Promise, Barrier.Lock, Barrier.Waiters);
+}
+
+void FBarrierAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	// The arrival itself cannot be undone
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FBarrierAwaiter*>(This);
+		auto& Barrier = Awaiter->Barrier;
+		CancelCore(Awaiter->Node, Promise, Barrier.Lock, Barrier.Waiters);
+	}
+}
+
+// Outlives the FCoroutineGroup if it has children that are still running
+class UE5Coro::Private::FCoroutineGroupState final
+{
+public:
+	UE::FMutex Lock;
+	// One for the group, and one per child that has not left yet
+	std::atomic<int> RefCount = 1;
+	FGroupNode* Head = nullptr;
+	bool bCanceled = false;
+	FWaitQueue Joiners;
+
+	void Release()
+	{
+		if (--RefCount == 0)
+			delete this;
+	}
+
+	void Add(const TCoroutine<>& Coroutine)
+	{
+		{
+			UE::TUniqueLock L(Lock);
+			UE::TUniqueLock PromiseLock(Coroutine.Extras->Lock);
+			// Holding the lock guarantees that Promise is active in the union
+			auto* Promise = Coroutine.Extras->Promise;
+			if (!Promise) // Already completed
+				return;
+
+			checkf(!Promise->GroupNode,
+			       TEXT("Coroutine is already in a group"));
+			auto& Node = *(Promise->GroupNode = new FGroupNode);
+			Node.Fn = &Leave;
+			Node.Promise = Promise;
+			Node.Group = this;
+			Node.GroupPrev = nullptr;
+			Node.GroupNext = std::exchange(Head, &Node);
+			if (Node.GroupNext)
+				Node.GroupNext->GroupPrev = &Node;
+			++RefCount;
+			Promise->AddContinuation(Node);
+
+			if (!bCanceled)
+				return;
+			Promise->Cancel(false);
+		}
+		ProcessExpeditedCancellations();
+	}
+
+	void Cancel()
+	{
+		{
+			UE::TUniqueLock L(Lock);
+			bCanceled = true;
+			// Children cannot leave while the lock is held, their nodes and
+			// promises remain valid for the duration of this loop
+			for (auto* Node = Head; Node; Node = Node->GroupNext)
+			{
+				auto* Promise = Node->Promise;
+				UE::TUniqueLock PromiseLock(Promise->GetLock());
+				if (Promise->Extras->Promise) // Is it already completing?
+					Promise->Cancel(false);
+			}
+		}
+		ProcessExpeditedCancellations();
+	}
+
+private:
+	static void Leave(FContinuationNode* InNode, void*)
+	{
+		auto* Node = static_cast<FGroupNode*>(InNode);
+		auto* This = Node->Group;
+		FWaitNode* Joiners = nullptr;
+		{
+			UE::TUniqueLock L(This->Lock);
+			(Node->GroupPrev ? Node->GroupPrev->GroupNext : This->Head) =
+				Node->GroupNext;
+			if (Node->GroupNext)
+				Node->GroupNext->GroupPrev = Node->GroupPrev;
+			if (!This->Head)
+				Joiners = This->Joiners.TakeAll();
+		}
+		delete Node; // The promise is being destroyed, it won't use it again
+		TryResumeAll(Joiners);
+		This->Release();
+	}
+
+	// Like TCoroutine::Cancel, expedited cancellations wait for the locks
+	static void ProcessExpeditedCancellations()
+	{
+		if (GCancelableAwaiterDepth == 0 && IsInGameThread())
+			FLatentPromise::ProcessExpeditedCancellations();
+	}
+};
+
+FCoroutineGroup::FCoroutineGroup()
+	: State(new FCoroutineGroupState)
+{
+}
+
+FCoroutineGroup::~FCoroutineGroup()
+{
+#if UE5CORO_DEBUG
+	{
+		UE::TUniqueLock L(State->Lock);
+		checkf(State->Joiners.IsEmpty(),
+		       TEXT("Coroutine group destroyed with active awaiters"));
+	}
+#endif
+	State->Cancel();
+	State->Release();
+}
+
+void FCoroutineGroup::Add(const TCoroutine<>& Coroutine)
+{
+	State->Add(Coroutine);
+}
+
+FGroupJoinAwaiter FCoroutineGroup::Join()
+{
+	return FGroupJoinAwaiter(*State);
+}
+
+void FCoroutineGroup::Cancel()
+{
+	State->Cancel();
+}
+
+int FCoroutineGroup::Num() const noexcept
+{
+	// Not counting the group itself
+	return State->RefCount.load(std::memory_order_relaxed) - 1;
+}
+
+bool FGroupJoinAwaiter::await_ready()
+{
+	State.Lock.Lock();
+	if (!State.Head)
+	{
+		State.Lock.Unlock();
+		return true;
+	}
+	return false; // Leave it locked
+}
+
+void FGroupJoinAwaiter::Suspend(FPromise& Promise)
+{
+	SuspendCore(this, Node, Promise, State.Lock, State.Joiners);
+}
+
+void FGroupJoinAwaiter::Cancel(void* This, FPromise& Promise)
+{
+	if (Promise.UnregisterCancelableAwaiter<false>())
+	{
+		auto* Awaiter = static_cast<FGroupJoinAwaiter*>(This);
+		CancelCore(Awaiter->Node, Promise, Awaiter->State.Lock,
+		           Awaiter->State.Joiners);
 	}
 }
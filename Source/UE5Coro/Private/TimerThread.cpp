@@ -30,10 +30,37 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TimerThread.h"
+#include "HAL/IConsoleManager.h"
 #include "UE5Coro/AsyncAwaiter.h"
 
 using namespace UE5Coro::Private;
 
+namespace
+{
+TAutoConsoleVariable<float> CVarTimerSlack(
+	TEXT("UE5Coro.TimerSlack"), 0,
+	TEXT("Allow PlatformSeconds and related awaiters to resume up to this "
+	     "many milliseconds late, so that nearby timers can be resumed "
+	     "together with fewer timer thread wakeups."));
+
+TAutoConsoleVariable<float> CVarTimerSpinMargin(
+	TEXT("UE5Coro.TimerSpinMargin"), 0,
+	TEXT("If positive, the timer thread wakes up this many milliseconds before "
+	     "a timer is due, and spins until its exact time, for sub-millisecond "
+	     "precision at the cost of CPU time. 0 disables spinning."));
+
+uint64 GetSlackTicks(double Resolution)
+{
+	auto Slack = CVarTimerSlack.GetValueOnAnyThread() / 1000.0;
+	return Slack > 0 ? static_cast<uint64>(Slack / Resolution) : 0;
+}
+
+double GetSpinMargin()
+{
+	return FMath::Max(0.0, CVarTimerSpinMargin.GetValueOnAnyThread() / 1000.0);
+}
+}
+
 std::once_flag FTimerThread::Once;
 FTimerThread* FTimerThread::Instance;
 
@@ -46,27 +73,51 @@ FTimerThread& FTimerThread::Get()
 void FTimerThread::Register(FAsyncTimeAwaiter* Awaiter)
 {
 	UE::TUniqueLock L(Lock);
-	Queue.HeapPush(Awaiter, &Less);
-	Event->Trigger();
+	checkf(Awaiter->Bucket == INDEX_NONE,
+	       TEXT("Internal error: double timer registration"));
+	// In high-precision mode, the wheel only needs to wake up the timer thread
+	// early enough to start spinning
+	Awaiter->Tick = ToTick(Awaiter->TargetTime - GetSpinMargin());
+	Link(Awaiter);
+
+	// Only wake the timer thread if it would otherwise oversleep this timer
+	if (auto Latest = Awaiter->Tick + GetSlackTicks(Resolution);
+	    Latest < WakeTick)
+	{
+		WakeTick = Latest;
+		Event->Trigger();
+	}
 }
 
 bool FTimerThread::TryUnregister(FAsyncTimeAwaiter* Awaiter)
 {
 	UE::TUniqueLock L(Lock);
-	// Slow, but this function is called relatively rarely
-	auto Idx = Queue.Find(Awaiter);
-	if (Idx == INDEX_NONE)
+	// Expired awaiters are unlinked before they're resumed
+	if (Awaiter->Bucket == INDEX_NONE)
 		return false;
-	Queue.HeapRemoveAt(Idx, &Less);
+	Unlink(Awaiter);
 	return true;
 }
 
 FTimerThread::FTimerThread()
 	: Event(FPlatformProcess::GetSynchEventFromPool())
+	, Epoch(FPlatformTime::Seconds())
 	, Thread(TEXT("UE5Coro Timer Thread"), [this] { Run(); })
 {
 }
 
+FTimerThread::FTimerThread(FNoThread)
+	: Event(FPlatformProcess::GetSynchEventFromPool()), Epoch(0)
+{
+}
+
+FTimerThread::~FTimerThread()
+{
+	checkf(!Thread.IsJoinable(),
+	       TEXT("Internal error: destroying the running timer thread"));
+	FPlatformProcess::ReturnSynchEventToPool(Event);
+}
+
 void FTimerThread::Run()
 {
 	for (;;)
@@ -75,31 +126,217 @@ void FTimerThread::Run()
 
 void FTimerThread::RunOnce()
 {
-	auto Wait = FTimespan::MaxValue();
+	TArray<FExpired> Expired;
+	auto WakeTime = std::numeric_limits<double>::max();
+	auto SpinTime = WakeTime;
 	{
 		UE::TUniqueLock L(Lock);
-		if (Queue.Num() > 0)
+		auto Now = FPlatformTime::Seconds();
+		auto Elapsed = (Now - Epoch) / Resolution;
+		Advance(Elapsed > 0 ? static_cast<uint64>(Elapsed) : 0, Now, Expired);
+		SpinTime = ExpireSpinning(Now, Expired);
+		if (auto Next = NextEventTick(); Next != MAX_uint64)
 		{
-			auto Remaining = FTimespan::FromSeconds(
-				Queue.HeapTop()->TargetTime - FPlatformTime::Seconds());
-			Wait = FMath::Max(FTimespan::Zero(), Remaining);
+			WakeTick = Next + GetSlackTicks(Resolution);
+			WakeTime = Epoch + static_cast<double>(WakeTick) * Resolution;
 		}
+		else
+			WakeTick = MAX_uint64;
 	}
-	Event->Wait(Wait);
-	UE::TUniqueLock L(Lock);
-	auto Now = FPlatformTime::Seconds();
-	while (Queue.Num() > 0)
-		if (auto& Next = Queue.HeapTop(); Next->TargetTime <= Now)
+
+	// Resume everything that expired in one batch, without holding the lock.
+	// The awaiters have been unlinked, and they might already be gone.
+	for (auto& Entry : Expired)
+		if (Entry.Callback)
+			Entry.Callback->OnExpired(*Entry.Callback);
+		else
+			FAsyncTimeAwaiter::Resume(*Entry.Promise, Entry.Thread);
+
+	// Spin-yield if a timer in high-precision mode is about to be due.
+	// Registrations are picked up by the next RunOnce.
+	if (SpinTime != std::numeric_limits<double>::max())
+	{
+		if (FPlatformTime::Seconds() < SpinTime)
+			FPlatformProcess::Yield();
+		return;
+	}
+
+	// Registrations since the lock was released will have triggered the event
+	if (WakeTime == std::numeric_limits<double>::max())
+		Event->Wait(FTimespan::MaxValue());
+	else if (auto Remaining = WakeTime - FPlatformTime::Seconds(); Remaining > 0)
+		Event->Wait(FTimespan::FromSeconds(Remaining));
+}
+
+uint64 FTimerThread::ToTick(double Time) const
+{
+	// Round up, so that timers never expire early
+	auto Ticks = FMath::CeilToDouble((Time - Epoch) / Resolution);
+	if (!(Ticks > 0)) // Also catches NaN
+		return 0;
+	return static_cast<uint64>(FMath::Min(Ticks, 0x1p62));
+}
+
+uint64 FTimerThread::NextEventTick() const
+{
+	if (Buckets[DueBucket])
+		return CurrentTick;
+
+	// Every awaiter on level N is in a slot after the current tick's Nth digit.
+	// The earliest occupied slot is either expiring (level 0) or cascading.
+	auto Next = MAX_uint64;
+	for (int Level = 0; Level < NumLevels; ++Level)
+	{
+		auto Shift = Level * LevelBits;
+		auto Digit = (CurrentTick >> Shift) & SlotMask;
+		if (auto Later = Occupied[Level] & ~((2ull << Digit) - 1))
 		{
-			Next->Resume();
-			Queue.HeapPopDiscard(&Less);
+			auto Base = CurrentTick >> (Shift + LevelBits) << (Shift + LevelBits);
+			auto Slot = static_cast<uint64>(FMath::CountTrailingZeros64(Later));
+			Next = FMath::Min(Next, Base | (Slot << Shift));
 		}
-		else
+	}
+	if (Buckets[OverflowBucket])
+	{
+		constexpr int Shift = NumLevels * LevelBits;
+		Next = FMath::Min(Next, ((CurrentTick >> Shift) + 1) << Shift);
+	}
+	return Next;
+}
+
+void FTimerThread::Link(FAsyncTimeAwaiter* Awaiter)
+{
+	int Bucket;
+	if (Awaiter->Tick <= CurrentTick)
+		Bucket = DueBucket;
+	else if (auto Level = static_cast<int>(
+	             FMath::FloorLog2_64(Awaiter->Tick ^ CurrentTick)) / LevelBits;
+	         Level < NumLevels)
+	{
+		auto Slot = (Awaiter->Tick >> (Level * LevelBits)) & SlotMask;
+		Occupied[Level] |= 1ull << Slot;
+		Bucket = Level * SlotsPerLevel + static_cast<int>(Slot);
+	}
+	else
+		Bucket = OverflowBucket;
+
+	Awaiter->Bucket = Bucket;
+	Awaiter->Prev = nullptr;
+	Awaiter->Next = Buckets[Bucket];
+	if (Awaiter->Next)
+		Awaiter->Next->Prev = Awaiter;
+	Buckets[Bucket] = Awaiter;
+}
+
+void FTimerThread::Unlink(FAsyncTimeAwaiter* Awaiter)
+{
+	auto Bucket = std::exchange(Awaiter->Bucket, INDEX_NONE);
+	if (Awaiter->Prev)
+		Awaiter->Prev->Next = Awaiter->Next;
+	else
+		Buckets[Bucket] = Awaiter->Next;
+	if (Awaiter->Next)
+		Awaiter->Next->Prev = Awaiter->Prev;
+	Awaiter->Prev = Awaiter->Next = nullptr;
+
+	if (!Buckets[Bucket] && Bucket < OverflowBucket)
+		Occupied[Bucket / SlotsPerLevel] &= ~(1ull << Bucket % SlotsPerLevel);
+}
+
+void FTimerThread::Advance(uint64 Now, double NowSeconds,
+                           TArray<FExpired>& Expired)
+{
+	ExpireBucket(DueBucket, NowSeconds, Expired);
+
+	// Jump from event to event instead of visiting every tick in between
+	while (CurrentTick < Now)
+	{
+		auto Next = NextEventTick();
+		if (Next > Now)
+		{
+			CurrentTick = Now;
 			break;
+		}
+
+		CurrentTick = Next;
+		if (auto Slot = Next & SlotMask; Slot != 0)
+			ExpireBucket(static_cast<int>(Slot), NowSeconds, Expired);
+		else
+		{
+			Cascade(Next);
+			ExpireBucket(DueBucket, NowSeconds, Expired);
+		}
+	}
 }
 
-// TArray auto-dereferencing requires an explicit predicate
-bool FTimerThread::Less(const FAsyncTimeAwaiter& A, const FAsyncTimeAwaiter& B)
+void FTimerThread::Cascade(uint64 Boundary)
 {
-	return A < B;
+	auto Relink = [this](int Bucket)
+	{
+		auto* Awaiter = std::exchange(Buckets[Bucket], nullptr);
+		if (Bucket < OverflowBucket)
+			Occupied[Bucket / SlotsPerLevel] &= ~(1ull << Bucket % SlotsPerLevel);
+		while (Awaiter)
+			Link(std::exchange(Awaiter, Awaiter->Next));
+	};
+
+	// Move awaiters down from every level that completed a full rotation,
+	// starting from the top. Level 0 has nothing to cascade.
+	if ((Boundary & ((1ull << (NumLevels * LevelBits)) - 1)) == 0)
+		Relink(OverflowBucket);
+	for (int Level = NumLevels - 1; Level > 0; --Level)
+		if (auto Shift = Level * LevelBits;
+		    (Boundary & ((1ull << Shift) - 1)) == 0)
+			Relink(Level * SlotsPerLevel +
+			       static_cast<int>((Boundary >> Shift) & SlotMask));
+}
+
+FTimerThread::FExpired FTimerThread::Expire(FAsyncTimeAwaiter* Awaiter)
+{
+	// The owner of an awaiter with OnExpired keeps it alive until it's called
+	if (Awaiter->OnExpired)
+		return {nullptr, Awaiter->Thread, Awaiter};
+	// Clearing this synchronizes with ~FAsyncTimeAwaiter
+	return {Awaiter->Promise.exchange(nullptr), Awaiter->Thread, nullptr};
+}
+
+void FTimerThread::ExpireBucket(int Bucket, double NowSeconds,
+                                TArray<FExpired>& Expired)
+{
+	while (auto* Awaiter = Buckets[Bucket])
+	{
+		Unlink(Awaiter);
+		// Awaiters that were registered in high-precision mode expire early
+		// from the wheel, keep them around until their exact time.
+		// This also protects against rounding in the tick calculation.
+		if (Awaiter->TargetTime > NowSeconds)
+		{
+			Awaiter->Bucket = SpinBucket;
+			Awaiter->Next = std::exchange(Buckets[SpinBucket], Awaiter);
+			if (Awaiter->Next)
+				Awaiter->Next->Prev = Awaiter;
+		}
+		else
+			Expired.Add(Expire(Awaiter));
+	}
+}
+
+double FTimerThread::ExpireSpinning(double NowSeconds,
+                                    TArray<FExpired>& Expired)
+{
+	// This list is short, it only has timers that are due within the margin
+	auto Earliest = std::numeric_limits<double>::max();
+	for (auto* Awaiter = Buckets[SpinBucket]; Awaiter;)
+	{
+		auto* Next = Awaiter->Next;
+		if (Awaiter->TargetTime <= NowSeconds)
+		{
+			Unlink(Awaiter);
+			Expired.Add(Expire(Awaiter));
+		}
+		else
+			Earliest = FMath::Min(Earliest, Awaiter->TargetTime);
+		Awaiter = Next;
+	}
+	return Earliest;
 }
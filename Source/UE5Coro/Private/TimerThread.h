@@ -34,18 +34,44 @@
 #include "CoreMinimal.h"
 #include "UE5Coro/Definition.h"
 #include <mutex>
+#include "Async/TaskGraphInterfaces.h"
 #include "UE5Coro/Private.h"
 
 namespace UE5Coro::Private
 {
+// Hierarchical timing wheel, see Varghese & Lauck. Awaiters are intrusively
+// linked into the buckets for O(1) registration and cancellation.
 class UE5CORO_API FTimerThread final
 {
+	friend Test::FTestHelper;
+
+	static constexpr int LevelBits = 6;
+	static constexpr int NumLevels = 4;
+	static constexpr int SlotsPerLevel = 1 << LevelBits;
+	static constexpr uint64 SlotMask = SlotsPerLevel - 1;
+	static constexpr int OverflowBucket = NumLevels * SlotsPerLevel;
+	static constexpr int DueBucket = OverflowBucket + 1;
+	static constexpr int SpinBucket = DueBucket + 1; // High-precision mode
+	static constexpr int NumBuckets = SpinBucket + 1;
+	static constexpr double Resolution = 0.001; // Seconds per tick
+
+	struct FExpired
+	{
+		FPromise* Promise;
+		ENamedThreads::Type Thread;
+		FAsyncTimeAwaiter* Callback; // Replaces Promise for OnExpired
+	};
+
 	static std::once_flag Once;
 	static FTimerThread* Instance;
 
 	FEvent* Event;
 	UE::FMutex Lock;
-	TArray<FAsyncTimeAwaiter*> Queue;
+	double Epoch;
+	uint64 CurrentTick = 0; // Every tick up to and including this has expired
+	uint64 WakeTick = MAX_uint64; // When the timer thread plans to wake up
+	uint64 Occupied[NumLevels] = {};
+	FAsyncTimeAwaiter* Buckets[NumBuckets] = {};
 	FThread Thread; // This one must come last
 
 public:
@@ -54,11 +80,23 @@ public:
 	bool TryUnregister(FAsyncTimeAwaiter*);
 
 private:
+	struct FNoThread { };
+
 	explicit FTimerThread();
-	~FTimerThread() = delete;
+	// Time only passes in explicit Advance calls, used by tests
+	explicit FTimerThread(FNoThread);
+	~FTimerThread(); // Only called for FNoThread, the instance is never freed
 	void Run();
 	void RunOnce();
-	[[nodiscard]] static bool Less(const FAsyncTimeAwaiter& A,
-	                               const FAsyncTimeAwaiter& B);
+	[[nodiscard]] uint64 ToTick(double Time) const;
+	[[nodiscard]] uint64 NextEventTick() const;
+	void Link(FAsyncTimeAwaiter*);
+	void Unlink(FAsyncTimeAwaiter*);
+	void Advance(uint64 Now, double NowSeconds, TArray<FExpired>& Expired);
+	void Cascade(uint64 Boundary);
+	[[nodiscard]] static FExpired Expire(FAsyncTimeAwaiter*);
+	void ExpireBucket(int Bucket, double NowSeconds, TArray<FExpired>& Expired);
+	[[nodiscard]] double ExpireSpinning(double NowSeconds,
+	                                    TArray<FExpired>& Expired);
 };
 }
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/UE5CoroSubsystem.h"
+#include "UE5Coro/Promise.h"
 #include "UE5CoroChainCallbackTarget.h"
 
 using namespace UE5Coro::Private;
@@ -107,6 +108,10 @@ void UUE5CoroSubsystem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	// Clean up latent coroutines that were canceled from other threads before
+	// their latent actions get a chance to poll their awaiters
+	FLatentPromise::ProcessExpeditedCancellations();
+
 #if UE_VERSION_OLDER_THAN(5, 5, 0)
 	// ProcessLatentActions refuses to work on non-BP classes before UE5.5.
 	GetClass()->ClassFlags |= CLASS_CompiledFromBlueprint;
@@ -0,0 +1,127 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "WorkStealingDeque.h"
+
+using namespace UE5Coro::Private;
+
+FWorkStealingDeque::FBuffer::FBuffer(int64 Capacity)
+	: Mask(Capacity - 1), Items(new std::atomic<FPromise*>[Capacity])
+{
+	checkf(FMath::IsPowerOfTwo(Capacity),
+	       TEXT("Internal error: invalid deque capacity"));
+}
+
+FPromise* FWorkStealingDeque::FBuffer::Get(int64 Index) const
+{
+	return Items[Index & Mask].load(std::memory_order_relaxed);
+}
+
+void FWorkStealingDeque::FBuffer::Put(int64 Index, FPromise* Promise)
+{
+	Items[Index & Mask].store(Promise, std::memory_order_relaxed);
+}
+
+FWorkStealingDeque::FWorkStealingDeque(int64 InitialCapacity)
+{
+	Buffers.Add(std::make_unique<FBuffer>(InitialCapacity));
+	Buffer.store(Buffers.Last().get(), std::memory_order_relaxed);
+}
+
+void FWorkStealingDeque::Push(FPromise* Promise)
+{
+	int64 B = Bottom.load(std::memory_order_relaxed);
+	int64 T = Top.load(std::memory_order_acquire);
+	auto* Array = Buffer.load(std::memory_order_relaxed);
+	if (B - T > Array->Mask) [[unlikely]]
+		Array = Grow(Array, B, T);
+	Array->Put(B, Promise);
+	std::atomic_thread_fence(std::memory_order_release);
+	Bottom.store(B + 1, std::memory_order_relaxed);
+}
+
+FPromise* FWorkStealingDeque::Pop()
+{
+	int64 B = Bottom.load(std::memory_order_relaxed) - 1;
+	auto* Array = Buffer.load(std::memory_order_relaxed);
+	Bottom.store(B, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 T = Top.load(std::memory_order_relaxed);
+
+	if (T > B) // Empty
+	{
+		Bottom.store(B + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto* Promise = Array->Get(B);
+	if (T == B) // Last item, race against stealers
+	{
+		if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst,
+		                                 std::memory_order_relaxed))
+			Promise = nullptr;
+		Bottom.store(B + 1, std::memory_order_relaxed);
+	}
+	return Promise;
+}
+
+FPromise* FWorkStealingDeque::Steal()
+{
+	int64 T = Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 B = Bottom.load(std::memory_order_acquire);
+	if (T >= B)
+		return nullptr;
+
+	auto* Promise = Buffer.load(std::memory_order_acquire)->Get(T);
+	// Losing this race means that another thread took this item
+	if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst,
+	                                 std::memory_order_relaxed))
+		return nullptr;
+	return Promise;
+}
+
+bool FWorkStealingDeque::IsEmpty() const
+{
+	return Top.load(std::memory_order_acquire) >=
+	       Bottom.load(std::memory_order_acquire);
+}
+
+FWorkStealingDeque::FBuffer* FWorkStealingDeque::Grow(FBuffer* Old, int64 B,
+                                                      int64 T)
+{
+	auto* New = Buffers.Add_GetRef(
+		std::make_unique<FBuffer>((Old->Mask + 1) * 2)).get();
+	for (int64 i = T; i < B; ++i)
+		New->Put(i, Old->Get(i));
+	Buffer.store(New, std::memory_order_release);
+	return New;
+}
@@ -0,0 +1,75 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <atomic>
+#include <memory>
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro::Private
+{
+/** Chase-Lev work-stealing deque (Lê et al., "Correct and Efficient
+ *  Work-Stealing for Weak Memory Models").
+ *  Push and Pop may only be called by the owning thread, Steal by any thread. */
+class FWorkStealingDeque final
+{
+	struct FBuffer final
+	{
+		int64 Mask;
+		std::unique_ptr<std::atomic<FPromise*>[]> Items;
+
+		explicit FBuffer(int64 Capacity);
+		FPromise* Get(int64 Index) const;
+		void Put(int64 Index, FPromise* Promise);
+	};
+
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> Top = 0;
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> Bottom = 0;
+	std::atomic<FBuffer*> Buffer;
+	// Every buffer that was ever used, stealers might still be reading old ones
+	TArray<std::unique_ptr<FBuffer>> Buffers;
+
+public:
+	explicit FWorkStealingDeque(int64 InitialCapacity = 256);
+	UE_NONCOPYABLE(FWorkStealingDeque);
+
+	void Push(FPromise*);
+	[[nodiscard]] FPromise* Pop();
+	[[nodiscard]] FPromise* Steal();
+	[[nodiscard]] bool IsEmpty() const;
+
+private:
+	FBuffer* Grow(FBuffer* Old, int64 B, int64 T);
+};
+}
@@ -39,11 +39,18 @@
 #include "UE5Coro/AggregateAwaiter.h"
 #include "UE5Coro/AnimationAwaiter.h"
 #include "UE5Coro/AsyncAwaiter.h"
+#include "UE5Coro/AsyncGenerator.h"
+#include "UE5Coro/AwaitableFuture.h"
+#include "UE5Coro/BroadcastChannel.h"
 #include "UE5Coro/Cancellation.h"
+#include "UE5Coro/Channel.h"
 #include "UE5Coro/Coroutine.h"
 #include "UE5Coro/CoroutineAwaiter.h"
+#include "UE5Coro/CoroutineExecutor.h"
+#include "UE5Coro/CoroutineLocal.h"
 #include "UE5Coro/Generator.h"
 #include "UE5Coro/HttpAwaiter.h"
+#include "UE5Coro/LatentAdmission.h"
 #include "UE5Coro/LatentAwaiter.h"
 #include "UE5Coro/LatentCallback.h"
 #include "UE5Coro/LatentTimeline.h"
@@ -33,9 +33,13 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definition.h"
+#include <array>
+#include <functional>
+#include "UE5Coro/AsyncAwaiter.h"
 #include "UE5Coro/CoroutineAwaiter.h"
 #include "UE5Coro/Private.h"
 #include "UE5Coro/Promise.h"
+#include "UE5Coro/Threading.h"
 
 namespace UE5Coro
 {
@@ -77,6 +81,43 @@ auto WhenAll(TAwaitable auto&&...) -> Private::FAllAwaiter;
 /** Returns an object that when co_awaited, resumes its awaiting coroutine once
  *  all the provided coroutines have finished. */
 UE5CORO_API auto WhenAll(const TArray<TCoroutine<>>&) -> Private::FAllAwaiter;
+
+/** Returns an object that when co_awaited, resumes its awaiting coroutine once
+ *  all the provided coroutines have finished, like WhenAll.
+ *
+ *  The result of the await expression is a TTuple of the coroutines' results,
+ *  which are moved out of them. Unsuccessful coroutines result in T(). */
+template<typename... T>
+	requires (sizeof...(T) > 0 && (!std::is_void_v<T> && ...))
+auto WhenAllResults(TCoroutine<T>...) -> Private::TAllResultsAwaiter<T...>;
+
+/** Returns an object that when co_awaited, resumes its awaiting coroutine once
+ *  all the provided coroutines have finished, like WhenAll.
+ *
+ *  The result of the await expression is a TArray of the coroutines' results in
+ *  the same order, which are moved out of them.
+ *  Unsuccessful coroutines result in T(). */
+template<typename T> requires (!std::is_void_v<T>)
+auto WhenAllResults(TArray<TCoroutine<T>>)
+	-> Private::TAllResultsArrayAwaiter<T>;
+}
+
+namespace UE5Coro::Async
+{
+/** Calls Fn with each element of Range, keeping at most MaxInFlight of the
+ *  coroutines that it returns running at the same time, and starting the next
+ *  one as soon as one of them completes.
+ *  Returns an object that when co_awaited, starts the work, and resumes its
+ *  awaiting coroutine once the coroutine of every element has completed.
+ *
+ *  The result of the await expression is the sorted indices of the elements
+ *  whose coroutines were unsuccessful.
+ *  Canceling the awaiting coroutine cancels the running coroutines and starts
+ *  no new ones.
+ *  Range and Fn must remain valid until the await expression completes. */
+template<typename R, typename F>
+auto ForEachConcurrent(R&& Range, int MaxInFlight, F Fn)
+	-> Private::FForEachConcurrentAwaiter;
 }
 
 namespace UE5Coro::Latent
@@ -103,6 +144,37 @@ namespace UE5Coro::Private
 class [[nodiscard]] UE5CORO_API FAggregateAwaiter
 	: public TCancelableAwaiter<FAggregateAwaiter>
 {
+	struct FData;
+	struct FWait;
+
+	// TCoroutine parameters are continued directly instead of being Consumed
+	struct FContinuation final : FContinuationNode
+	{
+		std::shared_ptr<FData> Data; // Released when the coroutine completes
+		int Index = -1;
+	};
+
+	// Copy of a time awaiter parameter that expires into its FWait
+	struct FTimer final : FAsyncTimeAwaiter
+	{
+		FWait* Wait;
+
+		explicit FTimer(const FAsyncTimeAwaiter& Awaiter, FWait* Wait)
+			: FAsyncTimeAwaiter(Awaiter), Wait(Wait) { }
+	};
+
+	// Event, semaphore, and time awaiter parameters are waited for directly
+	// instead of being Consumed. Exactly one of Cancel or the event, semaphore,
+	// or timer thread ends a registered wait.
+	struct FWait final : FWaitNode
+	{
+		std::shared_ptr<FData> Data; // Released when the wait ends
+		int Index = -1;
+		FAwaitableEvent* Event = nullptr;
+		FAwaitableSemaphore* Semaphore = nullptr;
+		TOptional<FTimer> Timer;
+	};
+
 	struct FData
 	{
 		UE::FMutex Lock;
@@ -110,6 +182,10 @@ class [[nodiscard]] UE5CORO_API FAggregateAwaiter
 		int Count;
 		int Index = -1;
 		TArray<TCoroutine<>> Handles;
+		// Not resized after being continued, the nodes must not move
+		TArray<FContinuation, TInlineAllocator<2>> Continuations;
+		// Not resized after being registered, the nodes must not move
+		TArray<FWait, TInlineAllocator<2>> Waits;
 		FPromise* Promise = nullptr;
 
 		explicit FData(int Count) : Count(Count) { }
@@ -119,6 +195,37 @@ class [[nodiscard]] UE5CORO_API FAggregateAwaiter
 
 	static TCoroutine<> Consume(std::shared_ptr<FData>, int, TAwaitable auto&&);
 	static void Cancel(void*, FPromise&);
+	// Returns the promise to resume if this completed the aggregate
+	static FPromise* Arrive(FData&, int Index);
+	static void OnCoroutineCompleted(FContinuationNode*, void*);
+	static bool OnWaitResumed(FWaitNode&, bool bDispatch);
+	static void OnTimerExpired(FAsyncTimeAwaiter&);
+	static bool TryUnregister(FWait&);
+	void Continue(const TCoroutine<>&, int Index, int Slot);
+	void Register(FAwaitableEvent&, int Index, int Slot);
+	void Register(FAwaitableSemaphore&, int Index, int Slot);
+	void Register(const FAsyncTimeAwaiter&, int Index, int Slot);
+
+	template<typename T>
+	static constexpr bool bIsCoroutine =
+		std::derived_from<std::remove_cvref_t<T>, TCoroutine<>>;
+
+	template<typename T>
+	static constexpr bool bIsWait =
+		std::same_as<T, FAwaitableEvent&> ||
+		std::same_as<T, FAwaitableSemaphore&> ||
+		std::same_as<std::remove_cvref_t<T>, FAsyncTimeAwaiter>;
+
+	void Add(int Index, int& Slot, int& WaitSlot, auto&& Awaiter)
+	{
+		if constexpr (bIsCoroutine<decltype(Awaiter)>)
+			Continue(Awaiter, Index, Slot++);
+		else if constexpr (bIsWait<decltype(Awaiter)>)
+			Register(Awaiter, Index, WaitSlot++);
+		else
+			Data->Handles.Add(Consume(Data, Index,
+			                          std::forward<decltype(Awaiter)>(Awaiter)));
+	}
 
 protected:
 	int GetResumerIndex() const;
@@ -127,9 +234,12 @@ public:
 	explicit FAggregateAwaiter(int Count, TAwaitable auto&&... Awaiters)
 		: TCancelableAwaiter(&Cancel), Data(std::make_shared<FData>(Count))
 	{
-		int i = 0;
-		(Data->Handles.Add(Consume(Data, i++,
-			std::forward<decltype(Awaiters)>(Awaiters))), ...);
+		Data->Continuations.SetNum(
+			(0 + ... + bIsCoroutine<decltype(Awaiters)>));
+		Data->Waits.SetNum((0 + ... + bIsWait<decltype(Awaiters)>));
+		int i = 0, Slot = 0, WaitSlot = 0;
+		(Add(i++, Slot, WaitSlot, std::forward<decltype(Awaiters)>(Awaiters)),
+		 ...);
 	}
 
 	explicit FAggregateAwaiter(auto, const TArray<TCoroutine<>>& Coroutines);
@@ -180,6 +290,163 @@ public:
 	int await_resume() noexcept;
 };
 
+// Waits for coroutines directly with one continuation each, sharing a single
+// state object that's only allocated if the coroutines were not done already.
+// Derived classes own the coroutines, which must not move after await_ready.
+class [[nodiscard]] UE5CORO_API FAllResultsAwaiter
+	: public TCancelableAwaiter<FAllResultsAwaiter>
+{
+	struct FState;
+	FState* State = nullptr;
+	TCoroutine<>* Awaited = nullptr;
+	int NumAwaited = 0;
+
+	static void Cancel(void*, FPromise&);
+	static void Arrive(FState*);
+
+protected:
+	FAllResultsAwaiter();
+	FAllResultsAwaiter(FAllResultsAwaiter&&) noexcept;
+	~FAllResultsAwaiter();
+	[[nodiscard]] bool Ready(TCoroutine<>* Coroutines, int Num);
+
+public:
+	void Suspend(FPromise&);
+};
+
+template<typename... T>
+class [[nodiscard]] TAllResultsAwaiter final : public FAllResultsAwaiter
+{
+	std::array<TCoroutine<>, sizeof...(T)> Coroutines;
+
+	template<size_t... I>
+	TTuple<T...> MoveResults(std::index_sequence<I...>)
+	{
+		return TTuple<T...>(
+			static_cast<TCoroutine<T>&>(Coroutines[I]).MoveResult()...);
+	}
+
+public:
+	explicit TAllResultsAwaiter(TCoroutine<T>&&... Args)
+		: Coroutines{std::move(Args)...} { }
+	TAllResultsAwaiter(TAllResultsAwaiter&&) noexcept = default;
+
+	[[nodiscard]] bool await_ready()
+	{
+		return Ready(Coroutines.data(), sizeof...(T));
+	}
+
+	TTuple<T...> await_resume()
+	{
+		return MoveResults(std::index_sequence_for<T...>());
+	}
+};
+
+template<typename T>
+class [[nodiscard]] TAllResultsArrayAwaiter final : public FAllResultsAwaiter
+{
+	TArray<TCoroutine<>> Coroutines;
+
+public:
+	explicit TAllResultsArrayAwaiter(TArray<TCoroutine<T>>&& Array)
+	{
+		Coroutines.Reserve(Array.Num());
+		for (auto& Coro : Array)
+			Coroutines.Add(std::move(Coro));
+	}
+	TAllResultsArrayAwaiter(TAllResultsArrayAwaiter&&) noexcept = default;
+
+	[[nodiscard]] bool await_ready()
+	{
+		return Ready(Coroutines.GetData(), Coroutines.Num());
+	}
+
+	TArray<T> await_resume()
+	{
+		TArray<T> Results;
+		Results.Reserve(Coroutines.Num());
+		for (auto& Coro : Coroutines)
+			Results.Add(static_cast<TCoroutine<T>&>(Coro).MoveResult());
+		return Results;
+	}
+};
+
+// Type-erased bookkeeping for ForEachConcurrent.
+// Only the coroutines that are running are tracked, in a fixed set of slots.
+class [[nodiscard]] UE5CORO_API FForEachConcurrentState
+{
+	friend FForEachConcurrentAwaiter;
+
+	UE::FMutex Lock;
+	const int MaxInFlight;
+	int NumInFlight = 0;
+	int NextIndex = 0;
+	bool bPumping = false; // Only one thread starts coroutines at a time
+	bool bExhausted = false;
+	bool bCanceled = false;
+	bool bFinished = false;
+	TArray<TOptional<TCoroutine<>>> Slots;
+	TArray<int> FreeSlots;
+	TArray<int> Failures;
+	FPromise* Promise = nullptr;
+
+protected:
+	explicit FForEachConcurrentState(int MaxInFlight);
+	UE_NONCOPYABLE(FForEachConcurrentState);
+	virtual ~FForEachConcurrentState() = default;
+
+	/** Calls Fn with the next element, if there's one left.
+	 *  Only called by the pumping thread, without holding Lock. */
+	[[nodiscard]] virtual TOptional<TCoroutine<>> StartNext() = 0;
+
+private:
+	static void Pump(const std::shared_ptr<FForEachConcurrentState>&);
+	static void Complete(const std::shared_ptr<FForEachConcurrentState>&,
+	                     int Slot, int Index);
+	[[nodiscard]] static bool Stop(const std::shared_ptr<FForEachConcurrentState>&);
+};
+
+template<typename R, typename F>
+class [[nodiscard]] TForEachConcurrentState final : public FForEachConcurrentState
+{
+	R Range; // A reference if an lvalue was provided
+	F Fn;
+	decltype(std::begin(std::declval<R&>())) It;
+	decltype(std::end(std::declval<R&>())) End;
+
+public:
+	explicit TForEachConcurrentState(R&& InRange, int MaxInFlight, F InFn)
+		: FForEachConcurrentState(MaxInFlight),
+		  Range(std::forward<R>(InRange)), Fn(std::move(InFn)),
+		  It(std::begin(Range)), End(std::end(Range)) { }
+
+private:
+	virtual TOptional<TCoroutine<>> StartNext() override
+	{
+		if (It != End)
+		{
+			TCoroutine<> Coroutine = std::invoke(Fn, *It);
+			++It;
+			return Coroutine;
+		}
+		return {};
+	}
+};
+
+class [[nodiscard]] UE5CORO_API FForEachConcurrentAwaiter
+	: public TCancelableAwaiter<FForEachConcurrentAwaiter>
+{
+	std::shared_ptr<FForEachConcurrentState> State;
+
+	static void Cancel(void*, FPromise&);
+
+public:
+	explicit FForEachConcurrentAwaiter(std::shared_ptr<FForEachConcurrentState>);
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	[[nodiscard]] TArray<int> await_resume();
+};
+
 struct UE5CORO_API FLatentAggregate final
 {
 	int RefCount;
@@ -223,6 +490,33 @@ auto UE5Coro::WhenAll(TAwaitable auto&&... Args) -> Private::FAllAwaiter
 	                            std::forward<decltype(Args)>(Args)...);
 }
 
+template<typename... T>
+	requires (sizeof...(T) > 0 && (!std::is_void_v<T> && ...))
+auto UE5Coro::WhenAllResults(TCoroutine<T>... Args)
+	-> Private::TAllResultsAwaiter<T...>
+{
+	return Private::TAllResultsAwaiter<T...>(std::move(Args)...);
+}
+
+template<typename T> requires (!std::is_void_v<T>)
+auto UE5Coro::WhenAllResults(TArray<TCoroutine<T>> Array)
+	-> Private::TAllResultsArrayAwaiter<T>
+{
+	return Private::TAllResultsArrayAwaiter<T>(std::move(Array));
+}
+
+template<typename R, typename F>
+auto UE5Coro::Async::ForEachConcurrent(R&& Range, int MaxInFlight, F Fn)
+	-> Private::FForEachConcurrentAwaiter
+{
+	using FResult = std::invoke_result_t<F&, decltype(*std::begin(Range))>;
+	static_assert(std::convertible_to<FResult, TCoroutine<>>,
+	              "Fn must return a TCoroutine");
+	return Private::FForEachConcurrentAwaiter(
+		std::make_shared<Private::TForEachConcurrentState<R, F>>(
+			std::forward<R>(Range), MaxInFlight, std::move(Fn)));
+}
+
 auto UE5Coro::Latent::WhenAny(TLatentContext<const UObject> LatentContext,
                               TAwaitable auto&&... Args)
 	-> Private::FLatentAnyAwaiter
@@ -243,17 +537,9 @@ template<UE5Coro::TAwaitable T>
 UE5Coro::TCoroutine<> UE5Coro::Private::FAggregateAwaiter::Consume(
 	std::shared_ptr<FData> Data, int Index, T&& Awaiter)
 {
-	ON_SCOPE_EXIT // Handle both success and cancellation
+	ON_SCOPE_EXIT // Success and cancellation
 	{
-		UE::TDynamicUniqueLock Lock(Data->Lock);
-		if (--Data->Count != 0)
-			return;
-		Data->Index = Index; // Mark that this index was the one reaching 0
-		auto* Promise = Data->Promise;
-		Lock.Unlock();
-
-		// Not co_awaited yet if Promise is nullptr, await_ready deals with this
-		if (Promise != nullptr && Promise->UnregisterCancelableAwaiter<true>())
+		if (auto* Promise = Arrive(*Data, Index))
 			Promise->Resume();
 	};
 
@@ -38,6 +38,7 @@
 #include "Async/TaskGraphInterfaces.h"
 #include "Misc/IQueuedWork.h"
 #include "Misc/QueuedThreadPool.h"
+#include "Tasks/Task.h"
 #include "UE5Coro/Private.h"
 #include "UE5Coro/Promise.h"
 
@@ -85,12 +86,18 @@ UE5CORO_API auto MoveToGameThread() noexcept -> Private::FAsyncAwaiter;
 UE5CORO_API auto MoveToSimilarThread() -> Private::FAsyncAwaiter;
 
 /** Returns an object that, when co_awaited, unconditionally suspends the
- *  calling coroutine, and resumes it in a UE::Tasks::TTask.
+ *  calling coroutine, and resumes it in a UE::Tasks::TTask launched with the
+ *  given priorities.
+ *  EExtendedTaskPriority::Inline will resume the coroutine immediately on its
+ *  current thread, the named thread variants will resume on that thread.
  *
  *  The return value of this function is reusable.
  *  Repeated co_awaits will keep resuming in a new TTask every time. */
-UE5CORO_API auto MoveToTask(const TCHAR* DebugName = nullptr)
-	-> Private::FTaskAwaiter;
+UE5CORO_API auto MoveToTask(
+	const TCHAR* DebugName = nullptr,
+	UE::Tasks::ETaskPriority Priority = UE::Tasks::ETaskPriority::Normal,
+	UE::Tasks::EExtendedTaskPriority ExtendedPriority =
+		UE::Tasks::EExtendedTaskPriority::None) -> Private::FTaskAwaiter;
 
 /** Returns an object that, when co_awaited, unconditionally suspends the
  *  calling coroutine, and queues it to resume on the provided thread pool with
@@ -129,6 +136,41 @@ UE5CORO_API auto MoveToNewThread(
 	EThreadCreateFlags Flags = EThreadCreateFlags::None) noexcept
 	-> Private::FNewThreadAwaiter;
 
+/** Returns an object that, when co_awaited, resumes the coroutine on a thread
+ *  from a pool dedicated to blocking work, such as file or process operations.
+ *  Unlike MoveToTask or MoveToThreadPool, this does not occupy workers that are
+ *  shared with the rest of the engine, and unlike MoveToNewThread, threads are
+ *  reused instead of being started for every co_await.
+ *
+ *  The pool grows on demand up to UE5Coro.BlockingPool.MaxThreads, then queues
+ *  coroutines. Threads exit after UE5Coro.BlockingPool.IdleTimeout seconds of
+ *  not being used.
+ *  For the parameters, see the engine function FRunnableThread::Create().
+ *
+ *  The return value of this function is reusable.
+ *  Repeated co_awaits will keep moving to the pool with the same parameters. */
+UE5CORO_API auto MoveToBlockingPool(
+	EThreadPriority Priority = TPri_Normal,
+	uint64 Affinity = FPlatformAffinity::GetNoAffinityMask()) noexcept
+	-> Private::FBlockingPoolAwaiter;
+
+/** Returns an object that, when co_awaited, resumes the coroutine on the game
+ *  thread in the next frame, as counted by FTSTicker::GetCoreTicker().
+ *  Unlike Latent::NextTick(), this does not need a world or a latent action.
+ *
+ *  The return value of this function is reusable. Repeated co_awaits will keep
+ *  waiting for the next frame. */
+UE5CORO_API auto NextFrame() noexcept -> Private::FAsyncFrameAwaiter;
+
+/** Returns an object that, when co_awaited, resumes the coroutine on the game
+ *  thread the given number of frames later, as counted by
+ *  FTSTicker::GetCoreTicker(). Frames are counted from the co_await.
+ *  Unlike Latent::Ticks(), this does not need a world or a latent action.
+ *
+ *  The return value of this function is reusable. Repeated co_awaits will keep
+ *  waiting for the same number of frames. */
+UE5CORO_API auto Frames(int64 Frames) noexcept -> Private::FAsyncFrameAwaiter;
+
 /** Returns an object that, when co_awaited, resumes the coroutine after the
  *  specified amount of time has elapsed since the call of this function (not
  *  the co_await!), based on FPlatformTime.
@@ -184,7 +226,9 @@ public:
 class [[nodiscard]] UE5CORO_API FAsyncTimeAwaiter
 	: public TCancelableAwaiter<FAsyncTimeAwaiter>
 {
-	friend class FTimerThread;
+	friend FAggregateAwaiter;
+	friend FTimerThread;
+	friend Test::FTestHelper;
 
 	double TargetTime;
 	union
@@ -193,6 +237,13 @@ class [[nodiscard]] UE5CORO_API FAsyncTimeAwaiter
 		ENamedThreads::Type Thread; // After suspension
 	};
 	std::atomic<FPromise*> Promise = nullptr;
+	// Called on the timer thread instead of resuming Promise, if set
+	void (*OnExpired)(FAsyncTimeAwaiter&) = nullptr;
+	// Intrusive timing wheel entry, guarded by FTimerThread
+	FAsyncTimeAwaiter* Prev = nullptr;
+	FAsyncTimeAwaiter* Next = nullptr;
+	uint64 Tick = 0;
+	int32 Bucket = INDEX_NONE;
 
 public:
 	explicit FAsyncTimeAwaiter(double TargetTime, bool bAnyThread) noexcept
@@ -206,12 +257,33 @@ public:
 
 private:
 	static void Cancel(void*, FPromise&);
-	void Resume();
+	static void Resume(FPromise&, ENamedThreads::Type);
+};
 
-	[[nodiscard]] auto operator<=>(const FAsyncTimeAwaiter& Other) const noexcept
-	{
-		return TargetTime <=> Other.TargetTime;
-	}
+class [[nodiscard]] UE5CORO_API FAsyncFrameAwaiter
+	: public TCancelableAwaiter<FAsyncFrameAwaiter>
+{
+	friend class FFrameTicker;
+
+	int64 Frames;
+	// These are guarded by FFrameTicker
+	uint64 TargetFrame = 0;
+	FPromise* Promise = nullptr;
+
+public:
+	explicit FAsyncFrameAwaiter(int64 Frames) noexcept
+		: TCancelableAwaiter(&Cancel), Frames(Frames) { }
+	FAsyncFrameAwaiter(const FAsyncFrameAwaiter& Other) noexcept
+		: FAsyncFrameAwaiter(Other.Frames) { }
+#if UE5CORO_DEBUG
+	~FAsyncFrameAwaiter();
+#endif
+
+	[[nodiscard]] bool await_ready() noexcept { return Frames <= 0; }
+	void Suspend(FPromise&);
+
+private:
+	static void Cancel(void*, FPromise&);
 };
 
 class [[nodiscard]] UE5CORO_API FAsyncYieldAwaiter
@@ -366,6 +438,19 @@ public:
 	bool await_resume() { return !bAbandoned; }
 };
 
+class [[nodiscard]] UE5CORO_API FBlockingPoolAwaiter
+	: public TAwaiter<FBlockingPoolAwaiter>
+{
+	EThreadPriority Priority;
+	uint64 Affinity;
+
+public:
+	explicit FBlockingPoolAwaiter(EThreadPriority Priority, uint64 Affinity)
+		: Priority(Priority), Affinity(Affinity) { }
+
+	void Suspend(FPromise&);
+};
+
 class [[nodiscard]] UE5CORO_API FNewThreadAwaiter
 	: public TAwaiter<FNewThreadAwaiter>
 {
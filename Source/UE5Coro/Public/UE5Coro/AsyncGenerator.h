@@ -0,0 +1,338 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <memory>
+#include "UE5Coro/Private.h"
+#include "UE5Coro/Promise.h"
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+struct FAsyncGeneratorWaitNode final : FWaitNode
+{
+	void* Item = nullptr; // TOptional<T>*
+};
+
+// Type-erased state shared by TAsyncGenerator and its coroutine.
+// The producer coroutine only runs while there's demand for its values: a
+// consumer is waiting for one, or the read-ahead buffer has room.
+class [[nodiscard]] UE5CORO_API FAsyncGeneratorState
+{
+	friend FAsyncGeneratorNextAwaiter;
+	friend FAsyncGeneratorYieldAwaiter;
+
+	UE::FMutex Lock;
+	FWaitQueue Consumers; // Only used while the buffer is empty
+	FPromise* Producer = nullptr; // Set while the producer is parked
+	int ReadAhead = 0;
+	bool bDone = false;
+
+protected:
+	// Ring buffer of the values that were yielded but not yet received,
+	// guarded by Lock. It only has room for one more than the read-ahead.
+	int Capacity = 1;
+	int Head = 0;
+	int Num = 0;
+
+	FAsyncGeneratorState() = default;
+	UE_NONCOPYABLE(FAsyncGeneratorState);
+	virtual ~FAsyncGeneratorState();
+
+	// These are called with Lock held
+	virtual void Store(int Index, void* Item) = 0; // Item is a T*
+	virtual void Load(int Index, void* Item) = 0; // Item is a TOptional<T>*
+	virtual void Transfer(void* From, void* To) = 0; // T* to TOptional<T>*
+	virtual void Resize(int NewCapacity) = 0; // Also moves Head to 0
+
+public:
+	void SetReadAhead(int Count);
+	void Finish(); // Called when the producer coroutine completes
+
+private:
+	[[nodiscard]] bool TryYield(FPromise&, void* Item,
+	                            FAsyncGeneratorWaitNode*& Consumer);
+	static void WakeProducer(FPromise&);
+};
+}
+#pragma endregion
+
+namespace UE5Coro
+{
+/** Asynchronous generator coroutine handle.
+ *  Make a function return TAsyncGenerator<T>, and it will be able to co_yield
+ *  values, and co_await anything that a TCoroutine could, e.g., to produce
+ *  values from paged HTTP requests or chunked file reads.
+ *  Consumers receive the values one by one with co_await Next().
+ *
+ *  The coroutine does not start running until the first value is requested,
+ *  and it does not run ahead of its consumers unless a read-ahead is set.
+ *  It runs as an async coroutine on whichever thread resumes it: usually the
+ *  consumer's, or the thread that finished the operation it was awaiting.
+ *
+ *  This object represents ownership of the coroutine, its destruction will
+ *  cancel the coroutine. */
+template<typename T>
+class [[nodiscard]] TAsyncGenerator final
+{
+	static_assert(!std::is_reference_v<T>, "References are not supported");
+	static_assert(std::is_move_constructible_v<T>,
+	              "TAsyncGenerator requires a move constructible type");
+
+public:
+	using promise_type = Private::TAsyncGeneratorPromise<T>;
+	friend promise_type;
+
+private:
+	std::shared_ptr<Private::TAsyncGeneratorState<T>> State;
+	TCoroutine<> Coroutine;
+
+	explicit TAsyncGenerator(std::shared_ptr<Private::TAsyncGeneratorState<T>>,
+	                         TCoroutine<>) noexcept;
+
+public:
+	TAsyncGenerator(const TAsyncGenerator&) = delete;
+	TAsyncGenerator(TAsyncGenerator&& Other) noexcept;
+	~TAsyncGenerator();
+
+	/** Replaces the underlying coroutine of this object with another.
+	 *  The coroutine that this object used to own is canceled. */
+	TAsyncGenerator& operator=(TAsyncGenerator&& Other) noexcept;
+
+	/** Returns an object that, when co_awaited, receives the next value,
+	 *  resuming the coroutine to produce it if needed.
+	 *  The result of the co_await expression is the value, or an empty
+	 *  TOptional if the coroutine completed without yielding another one. */
+	[[nodiscard]] auto Next() -> Private::TAsyncGeneratorNextAwaiter<T>;
+
+	/** Lets the coroutine produce up to Count values ahead of what has been
+	 *  requested, so that it runs in parallel with its consumers.
+	 *  The default is 0: values are only produced on request. */
+	void SetReadAhead(int Count);
+
+	/** Returns a non-owning handle to the coroutine producing the values. */
+	[[nodiscard]] TCoroutine<> GetCoroutine() const noexcept
+	{
+		return Coroutine;
+	}
+};
+}
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+template<typename T>
+class [[nodiscard]] TAsyncGeneratorState final : public FAsyncGeneratorState
+{
+	std::unique_ptr<TOptional<T>[]> Slots =
+		std::make_unique<TOptional<T>[]>(Capacity);
+
+	virtual void Store(int Index, void* Item) override
+	{
+		Slots[Index].Emplace(std::move(*static_cast<T*>(Item)));
+	}
+
+	virtual void Load(int Index, void* Item) override
+	{
+		auto& Slot = Slots[Index];
+		static_cast<TOptional<T>*>(Item)->Emplace(std::move(*Slot));
+		Slot.Reset();
+	}
+
+	virtual void Transfer(void* From, void* To) override
+	{
+		static_cast<TOptional<T>*>(To)->Emplace(
+			std::move(*static_cast<T*>(From)));
+	}
+
+	virtual void Resize(int NewCapacity) override
+	{
+		auto NewSlots = std::make_unique<TOptional<T>[]>(NewCapacity);
+		for (int i = 0; i < Num; ++i)
+			NewSlots[i].Emplace(std::move(*Slots[(Head + i) % Capacity]));
+		Slots = std::move(NewSlots);
+	}
+};
+
+class [[nodiscard]] UE5CORO_API FAsyncGeneratorNextAwaiter
+	: public TCancelableAwaiter<FAsyncGeneratorNextAwaiter>
+{
+protected:
+	FAsyncGeneratorState& State;
+	FAsyncGeneratorWaitNode Node;
+
+	explicit FAsyncGeneratorNextAwaiter(FAsyncGeneratorState& State, void* Item);
+	UE_NONCOPYABLE(FAsyncGeneratorNextAwaiter);
+
+public:
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+template<typename T>
+class [[nodiscard]] TAsyncGeneratorNextAwaiter final
+	: public FAsyncGeneratorNextAwaiter
+{
+	TOptional<T> Value;
+
+public:
+	explicit TAsyncGeneratorNextAwaiter(TAsyncGeneratorState<T>& State)
+		: FAsyncGeneratorNextAwaiter(State, &Value) { }
+
+	[[nodiscard]] TOptional<T> await_resume()
+	{
+		return std::move(Value);
+	}
+};
+
+// Also used for the initial suspension, with no item
+class [[nodiscard]] UE5CORO_API FAsyncGeneratorYieldAwaiter
+	: public TCancelableAwaiter<FAsyncGeneratorYieldAwaiter>
+{
+	FAsyncGeneratorState& State;
+	FPromise& Promise;
+	void* Item; // T*
+	FAsyncGeneratorWaitNode* Consumer = nullptr;
+
+public:
+	explicit FAsyncGeneratorYieldAwaiter(FAsyncGeneratorState& State,
+	                                     FPromise& Promise, void* Item);
+	UE_NONCOPYABLE(FAsyncGeneratorYieldAwaiter);
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	void await_resume() noexcept { }
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+template<typename T>
+class [[nodiscard]] TAsyncGeneratorYieldAwaiter final
+	: public FAsyncGeneratorYieldAwaiter
+{
+	T Value;
+
+public:
+	explicit TAsyncGeneratorYieldAwaiter(TAsyncGeneratorState<T>& State,
+	                                     FPromise& Promise, T&& InValue)
+		: FAsyncGeneratorYieldAwaiter(State, Promise, &Value),
+		  Value(std::move(InValue)) { }
+};
+
+template<typename T>
+class [[nodiscard]] TAsyncGeneratorPromise
+	: public TCoroutinePromise<void, FAsyncPromise, FPromiseExtras>
+{
+	using Super = TCoroutinePromise<void, FAsyncPromise, FPromiseExtras>;
+
+	std::shared_ptr<TAsyncGeneratorState<T>> State =
+		std::make_shared<TAsyncGeneratorState<T>>();
+
+public:
+	using Super::Super;
+
+	TAsyncGenerator<T> get_return_object()
+	{
+		auto Coroutine = Super::get_return_object();
+		// The coroutine's completion ends the sequence
+		Coroutine.ContinueWith([State = State] { State->Finish(); });
+		return TAsyncGenerator<T>(State, std::move(Coroutine));
+	}
+
+	// Wait for the first request before running
+	FAsyncGeneratorYieldAwaiter initial_suspend() noexcept
+	{
+		return FAsyncGeneratorYieldAwaiter(*State, *this, nullptr);
+	}
+
+	TAsyncGeneratorYieldAwaiter<T> yield_value(T Value)
+	{
+		return TAsyncGeneratorYieldAwaiter<T>(*State, *this, std::move(Value));
+	}
+};
+}
+
+template<typename T>
+UE5Coro::TAsyncGenerator<T>::TAsyncGenerator(
+	std::shared_ptr<Private::TAsyncGeneratorState<T>> State,
+	TCoroutine<> Coroutine) noexcept
+	: State(std::move(State)), Coroutine(std::move(Coroutine))
+{
+}
+
+template<typename T>
+UE5Coro::TAsyncGenerator<T>::TAsyncGenerator(TAsyncGenerator&& Other) noexcept
+	: State(std::move(Other.State)), Coroutine(Other.Coroutine)
+{
+}
+
+template<typename T>
+UE5Coro::TAsyncGenerator<T>::~TAsyncGenerator()
+{
+	if (State) // Not moved from
+		Coroutine.Cancel();
+}
+
+template<typename T>
+UE5Coro::TAsyncGenerator<T>& UE5Coro::TAsyncGenerator<T>::operator=(
+	TAsyncGenerator&& Other) noexcept
+{
+	if (this == &Other)
+		return *this;
+	if (State)
+		Coroutine.Cancel();
+	State = std::move(Other.State);
+	Coroutine = Other.Coroutine;
+	return *this;
+}
+
+template<typename T>
+auto UE5Coro::TAsyncGenerator<T>::Next()
+	-> Private::TAsyncGeneratorNextAwaiter<T>
+{
+	checkf(State, TEXT("Attempting to read from moved-from generator"));
+	return Private::TAsyncGeneratorNextAwaiter<T>(*State);
+}
+
+template<typename T>
+void UE5Coro::TAsyncGenerator<T>::SetReadAhead(int Count)
+{
+	checkf(State, TEXT("Attempting to use moved-from generator"));
+	State->SetReadAhead(Count);
+}
+#pragma endregion
@@ -0,0 +1,249 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <variant>
+#include "UE5Coro/Private.h"
+#include "UE5Coro/Promise.h"
+
+namespace UE5Coro
+{
+template<typename T = void>
+class TAwaitableFuture;
+
+/** Single-producer, single-consumer alternative to TPromise, which resumes the
+ *  coroutine awaiting its TAwaitableFuture directly from SetValue, without
+ *  allocating anything other than the state that the two objects share.
+ *  If this object is destroyed without a value, the awaiting coroutine is
+ *  canceled. If it's holding its cancellation, it receives T() instead. */
+template<typename T = void>
+class TAwaitablePromise final
+{
+	static_assert(!std::is_reference_v<T>, "References are not supported");
+
+	std::shared_ptr<Private::TAwaitableState<T>> State;
+	bool bFutureRetrieved = false;
+	bool bCompleted = false;
+
+public:
+	TAwaitablePromise();
+	TAwaitablePromise(TAwaitablePromise&&) noexcept = default;
+	TAwaitablePromise& operator=(TAwaitablePromise&&) = delete;
+	UE_NONCOPYABLE(TAwaitablePromise);
+	~TAwaitablePromise();
+
+	/** Returns the future that will receive this promise's value.
+	 *  May only be called once. */
+	[[nodiscard]] TAwaitableFuture<T> GetFuture();
+
+	/** Constructs the value from the arguments, and resumes the coroutine that's
+	 *  awaiting the future on this thread, if there's one.
+	 *  May only be called once. */
+	template<typename... A>
+	void SetValue(A&&... Args);
+};
+
+/** Receives the value of a TAwaitablePromise.
+ *  co_awaiting an lvalue results in a T& that refers to the value stored in the
+ *  future, co_awaiting an rvalue moves the value out.
+ *  Only one coroutine may await this object at a time. */
+template<typename T>
+class TAwaitableFuture final
+{
+	friend TAwaitablePromise<T>;
+
+	std::shared_ptr<Private::TAwaitableState<T>> State;
+
+	explicit TAwaitableFuture(std::shared_ptr<Private::TAwaitableState<T>> State)
+		: State(std::move(State)) { }
+
+public:
+	/** Creates an invalid future that's not associated with any promise. */
+	TAwaitableFuture() = default;
+	TAwaitableFuture(TAwaitableFuture&&) noexcept = default;
+	TAwaitableFuture& operator=(TAwaitableFuture&&) noexcept = default;
+	UE_NONCOPYABLE(TAwaitableFuture);
+
+	/** Returns true if this object is associated with a promise. */
+	[[nodiscard]] bool IsValid() const noexcept { return State != nullptr; }
+
+	/** Returns true if the value is available, co_awaiting this object will not
+	 *  suspend. */
+	[[nodiscard]] bool IsReady() const;
+
+	auto operator co_await() & -> Private::TAwaitableFutureAwaiter<T, false>;
+	auto operator co_await() && -> Private::TAwaitableFutureAwaiter<T, true>;
+};
+}
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FAwaitableStateBase
+{
+	friend FAwaitableFutureAwaiter;
+
+	// nullptr, the awaiting promise, or one of the completion markers
+	std::atomic<void*> Waiter = nullptr;
+
+public:
+	FAwaitableStateBase() = default;
+	UE_NONCOPYABLE(FAwaitableStateBase);
+
+	[[nodiscard]] bool IsReady() const;
+	[[nodiscard]] bool IsAbandoned() const;
+	void Complete(bool bAbandoned);
+
+private:
+	static void ResumeAbandoned(FPromise&);
+};
+
+template<typename T>
+class TAwaitableState final : public FAwaitableStateBase
+{
+public:
+	std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>>
+		Value;
+};
+
+class [[nodiscard]] UE5CORO_API FAwaitableFutureAwaiter
+	: public TCancelableAwaiter<FAwaitableFutureAwaiter>
+{
+protected:
+	FAwaitableStateBase* State;
+
+	explicit FAwaitableFutureAwaiter(FAwaitableStateBase* State)
+		: TCancelableAwaiter(&Cancel), State(State) { }
+
+public:
+	[[nodiscard]] bool await_ready() const;
+	void Suspend(FPromise&);
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+template<typename T, bool bMove>
+class [[nodiscard]] TAwaitableFutureAwaiter final
+	: public FAwaitableFutureAwaiter
+{
+	std::shared_ptr<TAwaitableState<T>> Owner;
+
+public:
+	explicit TAwaitableFutureAwaiter(std::shared_ptr<TAwaitableState<T>> State)
+		: FAwaitableFutureAwaiter(State.get()), Owner(std::move(State))
+	{
+		checkf(Owner, TEXT("Attempting to await an invalid TAwaitableFuture"));
+	}
+
+	decltype(auto) await_resume()
+	{
+		// Abandoned promises store T() for coroutines that held cancellations,
+		// this is only reachable without a value if T has no such constructor
+		if (!Owner->Value) [[unlikely]]
+			LowLevelFatalError(
+				TEXT("TAwaitablePromise was destroyed without a value"));
+		if constexpr (std::is_void_v<T>)
+			return;
+		else if constexpr (bMove)
+			return T(std::move(*Owner->Value));
+		else
+			return static_cast<T&>(*Owner->Value);
+	}
+};
+}
+
+template<typename T>
+UE5Coro::TAwaitablePromise<T>::TAwaitablePromise()
+	: State(std::make_shared<Private::TAwaitableState<T>>())
+{
+}
+
+template<typename T>
+UE5Coro::TAwaitablePromise<T>::~TAwaitablePromise()
+{
+	if (State && !bCompleted)
+	{
+		// If the awaiting coroutine is holding its cancellation, it will
+		// resume with this value, like a canceled TCoroutine's result
+		if constexpr (std::is_void_v<T> || std::is_default_constructible_v<T>)
+			State->Value.emplace();
+		State->Complete(true);
+	}
+}
+
+template<typename T>
+UE5Coro::TAwaitableFuture<T> UE5Coro::TAwaitablePromise<T>::GetFuture()
+{
+	checkf(State, TEXT("Attempting to use a moved-from TAwaitablePromise"));
+	checkf(!bFutureRetrieved, TEXT("The future was already retrieved"));
+	bFutureRetrieved = true;
+	return TAwaitableFuture<T>(State);
+}
+
+template<typename T>
+template<typename... A>
+void UE5Coro::TAwaitablePromise<T>::SetValue(A&&... Args)
+{
+	checkf(State, TEXT("Attempting to use a moved-from TAwaitablePromise"));
+	checkf(!bCompleted, TEXT("Attempting to set a value twice"));
+	bCompleted = true;
+	State->Value.emplace(std::forward<A>(Args)...);
+	State->Complete(false);
+}
+
+template<typename T>
+bool UE5Coro::TAwaitableFuture<T>::IsReady() const
+{
+	checkf(State, TEXT("Attempting to use an invalid TAwaitableFuture"));
+	return State->IsReady();
+}
+
+template<typename T>
+auto UE5Coro::TAwaitableFuture<T>::operator co_await() &
+	-> Private::TAwaitableFutureAwaiter<T, false>
+{
+	return Private::TAwaitableFutureAwaiter<T, false>(State);
+}
+
+template<typename T>
+auto UE5Coro::TAwaitableFuture<T>::operator co_await() &&
+	-> Private::TAwaitableFutureAwaiter<T, true>
+{
+	return Private::TAwaitableFutureAwaiter<T, true>(std::move(State));
+}
+#pragma endregion
@@ -0,0 +1,361 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <memory>
+#include "UE5Coro/Channel.h"
+#include "UE5Coro/Private.h"
+#include "UE5Coro/Promise.h"
+
+namespace UE5Coro
+{
+/** Determines what TBroadcastChannel does when a subscriber falls so far behind
+ *  that a new value would overwrite one it hasn't seen yet. */
+enum class EBroadcastOverflow : uint8
+{
+	/** Publishing never waits. Lagging subscribers skip the overwritten values,
+	 *  and continue with the oldest one that's still available. */
+	DropOldest,
+	/** Publishing suspends until the slowest subscriber catches up. */
+	BlockPublisher,
+};
+}
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+struct FBroadcastCursor final
+{
+	uint64 Position = 0;
+	uint64 NumDropped = 0;
+};
+
+// Type-erased bookkeeping for TBroadcastChannel. Unlike TChannel, every
+// operation takes the lock: it's needed to keep the cursors consistent.
+class [[nodiscard]] UE5CORO_API FBroadcastChannelBase
+{
+	friend FBroadcastNextAwaiter;
+	friend FBroadcastPublishAwaiter;
+	friend Test::FTestHelper;
+
+	UE::FMutex Lock;
+	const uint64 Capacity;
+	const EBroadcastOverflow Overflow;
+	uint64 Tail = 0; // Position of the next value
+	bool bClosed = false;
+	TArray<FBroadcastCursor*> Cursors;
+	FWaitQueue Readers; // Caught up subscribers waiting for the next value
+	FWaitQueue Publishers; // Only used with BlockPublisher
+
+protected:
+	explicit FBroadcastChannelBase(int Capacity, EBroadcastOverflow Overflow);
+	UE_NONCOPYABLE(FBroadcastChannelBase);
+	virtual ~FBroadcastChannelBase();
+
+	// These are called with Lock held
+	virtual void Store(uint64 Index, void* Item) = 0; // Item is a T*
+	// Item is a TSharedPtr<const T>*
+	virtual void Load(uint64 Index, void* Item) = 0;
+
+	void Subscribe(FBroadcastCursor&);
+	void Unsubscribe(FBroadcastCursor&);
+	[[nodiscard]] bool TryPublish(void* Item);
+	[[nodiscard]] bool TryNext(FBroadcastCursor&, void* Item);
+	void Close();
+	[[nodiscard]] bool IsClosed();
+
+private:
+	[[nodiscard]] bool IsFull() const;
+	[[nodiscard]] bool TryPublishLocked(FChannelWaitNode&);
+	void Park(FChannelWaitNode&, FPromise&, bool bFront);
+	void WakePublishers();
+};
+}
+#pragma endregion
+
+namespace UE5Coro
+{
+/** Single-buffer publish/subscribe channel: every subscriber receives every
+ *  value that's published after it subscribed, in order.
+ *  Values are stored once in a ring buffer that's shared by every subscriber,
+ *  each of which only keeps track of its own position in it. Published values
+ *  become immutable, and subscribers receive shared pointers to them, so
+ *  receiving a value never copies it.
+ *  The channel must outlive its subscribers. */
+template<typename T>
+class TBroadcastChannel final : Private::FBroadcastChannelBase
+{
+	static_assert(!std::is_reference_v<T>, "References are not supported");
+
+	template<typename> friend class Private::TBroadcastNextAwaiter;
+	template<typename> friend class Private::TBroadcastPublishAwaiter;
+	friend Private::Test::FTestHelper;
+
+	std::unique_ptr<TSharedPtr<const T>[]> Slots;
+	const uint64 NumSlots;
+
+public:
+	/** A subscription to a TBroadcastChannel. Move-only, it unsubscribes when
+	 *  it's destroyed. Only one coroutine may use it at a time. */
+	class FSubscriber final
+	{
+		friend TBroadcastChannel;
+
+		TBroadcastChannel* Channel;
+		std::unique_ptr<Private::FBroadcastCursor> Cursor;
+
+		explicit FSubscriber(TBroadcastChannel& Channel);
+
+	public:
+		FSubscriber(FSubscriber&&) noexcept = default;
+		FSubscriber& operator=(FSubscriber&&) noexcept;
+		~FSubscriber();
+
+		/** Returns an object that, when co_awaited, receives the next value,
+		 *  suspending the coroutine only if this subscriber has already seen
+		 *  every value. The result of the co_await expression is the value,
+		 *  shared with every other subscriber, or nullptr if the channel was
+		 *  closed and there are no values left for this subscriber. */
+		[[nodiscard]] auto Next() -> Private::TBroadcastNextAwaiter<T>;
+
+		/** Receives the next value without waiting, if there is one. */
+		[[nodiscard]] TSharedPtr<const T> TryNext();
+
+		/** Returns the number of values that were overwritten before this
+		 *  subscriber could receive them. Always 0 with BlockPublisher. */
+		[[nodiscard]] uint64 GetNumDropped() const noexcept;
+	};
+
+	/** Creates an open channel that keeps the last Capacity values. */
+	explicit TBroadcastChannel(
+		int Capacity, EBroadcastOverflow Overflow = EBroadcastOverflow::DropOldest);
+	UE_NONCOPYABLE(TBroadcastChannel);
+
+	/** Creates a new subscriber that will receive values published from now on. */
+	[[nodiscard]] FSubscriber Subscribe() { return FSubscriber(*this); }
+
+	/** Returns an object that, when co_awaited, publishes the value to every
+	 *  current subscriber. With BlockPublisher, the coroutine is suspended
+	 *  until there's room for the value.
+	 *  The result of the co_await expression is true if the value was
+	 *  published, false if the channel was closed. */
+	[[nodiscard]] auto Publish(T Value) -> Private::TBroadcastPublishAwaiter<T>;
+
+	/** Attempts to publish the value without waiting.
+	 *  The value is only moved from if this returns true. */
+	[[nodiscard]] bool TryPublish(T&& Value);
+	[[nodiscard]] bool TryPublish(const T& Value);
+
+	/** Closes the channel. Publishing fails from now on, subscribers receive
+	 *  their remaining values, then empty results. */
+	void Close() { FBroadcastChannelBase::Close(); }
+
+	/** @return true if Close() was called. */
+	[[nodiscard]] bool IsClosed() { return FBroadcastChannelBase::IsClosed(); }
+
+private:
+	virtual void Store(uint64 Index, void* Item) override;
+	virtual void Load(uint64 Index, void* Item) override;
+};
+}
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FBroadcastNextAwaiter
+	: public TCancelableAwaiter<FBroadcastNextAwaiter>
+{
+protected:
+	FBroadcastChannelBase& Channel;
+	FBroadcastCursor& Cursor;
+	FWaitNode Node;
+
+	explicit FBroadcastNextAwaiter(FBroadcastChannelBase& Channel,
+	                               FBroadcastCursor& Cursor)
+		: TCancelableAwaiter(&Cancel), Channel(Channel), Cursor(Cursor) { }
+
+	[[nodiscard]] bool TryNext(void* Item);
+
+public:
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+template<typename T>
+class [[nodiscard]] TBroadcastNextAwaiter final : public FBroadcastNextAwaiter
+{
+public:
+	explicit TBroadcastNextAwaiter(TBroadcastChannel<T>& Channel,
+	                               FBroadcastCursor& Cursor)
+		: FBroadcastNextAwaiter(Channel, Cursor) { }
+
+	// This is also reached by a canceled coroutine under FCancellationGuard,
+	// which might not have a value to receive yet
+	[[nodiscard]] TSharedPtr<const T> await_resume()
+	{
+		TSharedPtr<const T> Value;
+		(void)TryNext(&Value);
+		return Value;
+	}
+};
+
+class [[nodiscard]] UE5CORO_API FBroadcastPublishAwaiter
+	: public TCancelableAwaiter<FBroadcastPublishAwaiter>
+{
+protected:
+	FBroadcastChannelBase& Channel;
+	FChannelWaitNode Node;
+
+	explicit FBroadcastPublishAwaiter(FBroadcastChannelBase& Channel, void* Item);
+	UE_NONCOPYABLE(FBroadcastPublishAwaiter);
+
+public:
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	[[nodiscard]] bool await_resume() noexcept { return Node.bSucceeded; }
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+template<typename T>
+class [[nodiscard]] TBroadcastPublishAwaiter final
+	: public FBroadcastPublishAwaiter
+{
+	T Value;
+
+public:
+	explicit TBroadcastPublishAwaiter(TBroadcastChannel<T>& Channel,
+	                                  T&& InValue)
+		: FBroadcastPublishAwaiter(Channel, &Value), Value(std::move(InValue)) { }
+};
+}
+
+template<typename T>
+UE5Coro::TBroadcastChannel<T>::FSubscriber::FSubscriber(
+	TBroadcastChannel& Channel)
+	: Channel(&Channel), Cursor(std::make_unique<Private::FBroadcastCursor>())
+{
+	Channel.FBroadcastChannelBase::Subscribe(*Cursor);
+}
+
+template<typename T>
+auto UE5Coro::TBroadcastChannel<T>::FSubscriber::operator=(
+	FSubscriber&& Other) noexcept -> FSubscriber&
+{
+	if (this != &Other)
+	{
+		if (Cursor)
+			Channel->Unsubscribe(*Cursor);
+		Channel = Other.Channel;
+		Cursor = std::move(Other.Cursor);
+	}
+	return *this;
+}
+
+template<typename T>
+UE5Coro::TBroadcastChannel<T>::FSubscriber::~FSubscriber()
+{
+	if (Cursor)
+		Channel->Unsubscribe(*Cursor);
+}
+
+template<typename T>
+auto UE5Coro::TBroadcastChannel<T>::FSubscriber::Next()
+	-> Private::TBroadcastNextAwaiter<T>
+{
+	checkf(Cursor, TEXT("Attempting to use a moved-from subscriber"));
+	return Private::TBroadcastNextAwaiter<T>(*Channel, *Cursor);
+}
+
+template<typename T>
+TSharedPtr<const T> UE5Coro::TBroadcastChannel<T>::FSubscriber::TryNext()
+{
+	checkf(Cursor, TEXT("Attempting to use a moved-from subscriber"));
+	TSharedPtr<const T> Value;
+	(void)Channel->TryNext(*Cursor, &Value);
+	return Value;
+}
+
+template<typename T>
+uint64 UE5Coro::TBroadcastChannel<T>::FSubscriber::GetNumDropped() const noexcept
+{
+	return Cursor ? Cursor->NumDropped : 0;
+}
+
+template<typename T>
+UE5Coro::TBroadcastChannel<T>::TBroadcastChannel(int Capacity,
+                                                 EBroadcastOverflow Overflow)
+	: FBroadcastChannelBase(Capacity, Overflow),
+	  Slots(std::make_unique<TSharedPtr<const T>[]>(Capacity)),
+	  NumSlots(Capacity)
+{
+}
+
+template<typename T>
+auto UE5Coro::TBroadcastChannel<T>::Publish(T Value)
+	-> Private::TBroadcastPublishAwaiter<T>
+{
+	return Private::TBroadcastPublishAwaiter<T>(*this, std::move(Value));
+}
+
+template<typename T>
+bool UE5Coro::TBroadcastChannel<T>::TryPublish(T&& Value)
+{
+	return FBroadcastChannelBase::TryPublish(&Value);
+}
+
+template<typename T>
+bool UE5Coro::TBroadcastChannel<T>::TryPublish(const T& Value)
+{
+	T Copy(Value);
+	return TryPublish(std::move(Copy));
+}
+
+template<typename T>
+void UE5Coro::TBroadcastChannel<T>::Store(uint64 Index, void* Item)
+{
+	Slots[Index % NumSlots] = MakeShared<T>(std::move(*static_cast<T*>(Item)));
+}
+
+template<typename T>
+void UE5Coro::TBroadcastChannel<T>::Load(uint64 Index, void* Item)
+{
+	// Subscribers share the value, this only adds a reference
+	*static_cast<TSharedPtr<const T>*>(Item) = Slots[Index % NumSlots];
+}
+#pragma endregion
@@ -125,6 +125,58 @@ UE5CORO_API auto FinishNowIfCanceled() noexcept -> Private::FCancellationAwaiter
  *  @return True if the current coroutine is canceled.
  *  FCancellationGuards do not affect the return value of this function. */
 [[nodiscard]] UE5CORO_API bool IsCurrentCoroutineCanceled();
+
+/** Lightweight, copyable handle to an FCancellationSource, for coroutines to
+ *  link themselves to. Default-constructed tokens are never canceled. */
+class [[nodiscard]] UE5CORO_API FCancellationToken
+{
+	friend class FCancellationSource;
+	friend Private::FCancellationState;
+
+	std::shared_ptr<Private::FCancellationState> State;
+
+	explicit FCancellationToken(std::shared_ptr<Private::FCancellationState>);
+
+public:
+	FCancellationToken() = default;
+
+	/** @return True if the source of this token has been canceled. */
+	[[nodiscard]] bool IsCancellationRequested() const noexcept;
+};
+
+/** Cancels every coroutine that's linked to one of its tokens at once.
+ *  Coroutines linked after the source was canceled are canceled immediately.
+ *  Copies refer to the same source. */
+class [[nodiscard]] UE5CORO_API FCancellationSource
+{
+	std::shared_ptr<Private::FCancellationState> State;
+
+public:
+	FCancellationSource();
+
+	/** Returns a token that coroutines can be linked to. */
+	[[nodiscard]] FCancellationToken GetToken() const;
+
+	/** Cancels every coroutine that's currently linked to this source. */
+	void Cancel();
+
+	/** @return True if Cancel has been called. */
+	[[nodiscard]] bool IsCancellationRequested() const noexcept;
+};
+
+/** Links the calling coroutine to the token's source, replacing its previous
+ *  link, if any. Coroutines are unlinked automatically when they complete.
+ *  A default-constructed token unlinks the calling coroutine.
+ *  co_awaiting the return value processes the cancellation immediately if the
+ *  source has already been canceled, otherwise it does not suspend. */
+UE5CORO_API auto LinkCancellation(FCancellationToken)
+	-> Private::FLinkCancellationAwaiter;
+
+/** Links a coroutine that's not linked yet to the token's source, typically
+ *  right after it was created.
+ *  It's canceled immediately if the source has already been canceled. */
+UE5CORO_API void LinkCancellation(const FCancellationToken&,
+                                  const TCoroutine<>&);
 }
 
 #pragma region Private
@@ -137,5 +189,18 @@ public:
 	[[nodiscard]] bool await_ready();
 	void Suspend(FPromise&);
 };
+
+class [[nodiscard]] UE5CORO_API FLinkCancellationAwaiter
+	: public TAwaiter<FLinkCancellationAwaiter>
+{
+	FCancellationToken Token;
+
+public:
+	explicit FLinkCancellationAwaiter(FCancellationToken Token)
+		: Token(std::move(Token)) { }
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+};
 }
 #pragma endregion
@@ -0,0 +1,404 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <atomic>
+#include <memory>
+#include "UE5Coro/Private.h"
+#include "UE5Coro/Promise.h"
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+struct FChannelWaitNode final : FWaitNode
+{
+	void* Awaiter = nullptr;
+	void* Item = nullptr; // T* for senders, TOptional<T>* for receivers
+	bool bSucceeded = false; // Written by the thread that resumes the awaiter
+};
+
+// Type-erased waiting and waking logic for TChannel.
+// The buffer itself never needs this lock, it's only used to park coroutines.
+class [[nodiscard]] UE5CORO_API FChannelBase
+{
+	friend FChannelAwaiter;
+	friend Test::FTestHelper;
+
+	UE::FMutex Lock;
+	FWaitQueue Senders;
+	FWaitQueue Receivers;
+	// Number of parked coroutines, only incremented while Lock is held.
+	// This might briefly include coroutines that are not in the queues.
+	std::atomic<int> NumSenders = 0;
+	std::atomic<int> NumReceivers = 0;
+	std::atomic<bool> bClosed = false;
+
+protected:
+	FChannelBase() = default;
+	UE_NONCOPYABLE(FChannelBase);
+	virtual ~FChannelBase();
+
+	[[nodiscard]] virtual bool TryPush(void* Item) = 0;
+	[[nodiscard]] virtual bool TryPop(void* Item) = 0;
+
+	void Close();
+	[[nodiscard]] bool IsClosed() const noexcept;
+
+	/** Called after items were added to (bSent) or removed from the buffer
+	 *  without going through the slow path. Cheap if nobody is waiting. */
+	void Notify(bool bSent);
+
+private:
+	[[nodiscard]] bool TryComplete(FChannelWaitNode&, bool bSend);
+	void ResumeClosed(FWaitNode* Nodes, bool bSend);
+	void Park(FChannelWaitNode&, FPromise&, bool bSend, bool bFront);
+	void Wake(bool bSenders);
+	void Cancel(FChannelWaitNode&, FPromise&, bool bSend);
+};
+}
+#pragma endregion
+
+namespace UE5Coro
+{
+/** Bounded multi-producer, multi-consumer channel for passing values between
+ *  coroutines, or from regular code to coroutines.
+ *  co_await Send() suspends while the channel is full, co_await Receive()
+ *  suspends while it's empty. Sending and receiving when neither side needs to
+ *  wait is lock-free; the internal lock is only used to suspend and resume
+ *  coroutines.
+ *  Closing the channel fails every pending and future Send, and lets receivers
+ *  drain the values that were already sent. */
+template<typename T>
+class TChannel final : Private::FChannelBase
+{
+	static_assert(!std::is_reference_v<T>, "References are not supported");
+	static_assert(std::is_move_constructible_v<T>,
+	              "TChannel requires a move constructible type");
+
+	template<typename> friend class Private::TChannelSendAwaiter;
+	template<typename> friend class Private::TChannelReceiveAwaiter;
+	template<typename> friend class Private::TChannelReceiveManyAwaiter;
+	friend Private::Test::FTestHelper;
+
+	struct FCell final
+	{
+		std::atomic<uint64> Sequence;
+		TTypeCompatibleBytes<T> Storage;
+	};
+
+	// Vyukov's bounded MPMC queue: each cell's sequence number tells whether
+	// it's ready to be written or read at a given position.
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> SendPos = 0;
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> ReceivePos = 0;
+	const uint64 Capacity;
+	std::unique_ptr<FCell[]> Cells;
+
+public:
+	/** Creates an empty, open channel that can buffer Capacity values. */
+	explicit TChannel(int Capacity);
+	UE_NONCOPYABLE(TChannel);
+	virtual ~TChannel() override;
+
+	/** Returns an object that, when co_awaited, sends the value, suspending the
+	 *  coroutine while the channel is full.
+	 *  The result of the co_await expression is true if the value was sent,
+	 *  false if the channel was closed, in which case the value is destroyed. */
+	[[nodiscard]] auto Send(T Value) -> Private::TChannelSendAwaiter<T>;
+
+	/** Returns an object that, when co_awaited, receives a value, suspending
+	 *  the coroutine while the channel is empty.
+	 *  The result of the co_await expression is the value, or an empty
+	 *  TOptional if the channel was closed and there are no values left. */
+	[[nodiscard]] auto Receive() -> Private::TChannelReceiveAwaiter<T>;
+
+	/** Like Receive, but after the first value arrives, it also takes every
+	 *  other available value without waiting, up to MaxCount in total.
+	 *  The result of the co_await expression is an array of the values, which
+	 *  is only empty if the channel was closed and there are no values left. */
+	[[nodiscard]] auto ReceiveMany(int MaxCount)
+		-> Private::TChannelReceiveManyAwaiter<T>;
+
+	/** Attempts to send the value without waiting.
+	 *  The value is only moved from if this returns true. */
+	[[nodiscard]] bool TrySend(T&& Value);
+	[[nodiscard]] bool TrySend(const T& Value);
+
+	/** Attempts to send the values in order without waiting, and stops at the
+	 *  first one that doesn't fit.
+	 *  @return The number of values sent. These are moved from. */
+	int TrySendMany(TArrayView<T> Values);
+
+	/** Attempts to receive a value without waiting. */
+	[[nodiscard]] TOptional<T> TryReceive();
+
+	/** Closes the channel. Senders that are suspended or will send in the
+	 *  future fail, receivers get the remaining values, then empty results.
+	 *  Values sent concurrently with this call might still be received. */
+	void Close() { FChannelBase::Close(); }
+
+	/** @return true if Close() was called. */
+	[[nodiscard]] bool IsClosed() const noexcept
+	{
+		return FChannelBase::IsClosed();
+	}
+
+private:
+	[[nodiscard]] bool TryPushValue(T& Value);
+	[[nodiscard]] bool TryPopValue(TOptional<T>& Value);
+	virtual bool TryPush(void* Item) override;
+	virtual bool TryPop(void* Item) override;
+};
+}
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FChannelAwaiter
+	: public TCancelableAwaiter<FChannelAwaiter>
+{
+protected:
+	FChannelBase& Channel;
+	FChannelWaitNode Node;
+	bool bSend;
+
+	explicit FChannelAwaiter(FChannelBase& Channel, bool bSend, void* Item);
+	UE_NONCOPYABLE(FChannelAwaiter);
+
+public:
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+template<typename T>
+class [[nodiscard]] TChannelSendAwaiter final : public FChannelAwaiter
+{
+	T Value;
+
+public:
+	explicit TChannelSendAwaiter(TChannel<T>& Channel, T&& InValue)
+		: FChannelAwaiter(Channel, true, &Value), Value(std::move(InValue)) { }
+
+	[[nodiscard]] bool await_resume() noexcept { return Node.bSucceeded; }
+};
+
+template<typename T>
+class [[nodiscard]] TChannelReceiveAwaiter : public FChannelAwaiter
+{
+protected:
+	TOptional<T> Value;
+
+public:
+	explicit TChannelReceiveAwaiter(TChannel<T>& Channel)
+		: FChannelAwaiter(Channel, false, &Value) { }
+
+	[[nodiscard]] TOptional<T> await_resume()
+	{
+		return std::move(Value);
+	}
+};
+
+template<typename T>
+class [[nodiscard]] TChannelReceiveManyAwaiter final
+	: public TChannelReceiveAwaiter<T>
+{
+	int MaxCount;
+
+public:
+	explicit TChannelReceiveManyAwaiter(TChannel<T>& Channel, int MaxCount)
+		: TChannelReceiveAwaiter<T>(Channel), MaxCount(MaxCount)
+	{
+		checkf(MaxCount > 0, TEXT("Invalid count"));
+	}
+
+	[[nodiscard]] TArray<T> await_resume();
+};
+}
+
+template<typename T>
+UE5Coro::TChannel<T>::TChannel(int Capacity)
+	: Capacity(Capacity), Cells(std::make_unique<FCell[]>(Capacity))
+{
+	checkf(Capacity > 0, TEXT("Invalid capacity"));
+	for (uint64 i = 0; i < this->Capacity; ++i)
+		Cells[i].Sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+UE5Coro::TChannel<T>::~TChannel()
+{
+	TOptional<T> Value;
+	while (TryPopValue(Value))
+		Value.Reset();
+}
+
+template<typename T>
+auto UE5Coro::TChannel<T>::Send(T Value) -> Private::TChannelSendAwaiter<T>
+{
+	return Private::TChannelSendAwaiter<T>(*this, std::move(Value));
+}
+
+template<typename T>
+auto UE5Coro::TChannel<T>::Receive() -> Private::TChannelReceiveAwaiter<T>
+{
+	return Private::TChannelReceiveAwaiter<T>(*this);
+}
+
+template<typename T>
+auto UE5Coro::TChannel<T>::ReceiveMany(int MaxCount)
+	-> Private::TChannelReceiveManyAwaiter<T>
+{
+	return Private::TChannelReceiveManyAwaiter<T>(*this, MaxCount);
+}
+
+template<typename T>
+bool UE5Coro::TChannel<T>::TrySend(T&& Value)
+{
+	if (IsClosed() || !TryPushValue(Value))
+		return false;
+	Notify(true);
+	return true;
+}
+
+template<typename T>
+bool UE5Coro::TChannel<T>::TrySend(const T& Value)
+{
+	T Copy(Value);
+	return TrySend(std::move(Copy));
+}
+
+template<typename T>
+int UE5Coro::TChannel<T>::TrySendMany(TArrayView<T> Values)
+{
+	int Count = 0;
+	if (!IsClosed())
+		while (Count < Values.Num() && TryPushValue(Values[Count]))
+			++Count;
+	if (Count > 0)
+		Notify(true);
+	return Count;
+}
+
+template<typename T>
+TOptional<T> UE5Coro::TChannel<T>::TryReceive()
+{
+	TOptional<T> Value;
+	if (TryPopValue(Value))
+		Notify(false);
+	return Value;
+}
+
+template<typename T>
+bool UE5Coro::TChannel<T>::TryPushValue(T& Value)
+{
+	for (auto Pos = SendPos.load(std::memory_order_relaxed);;)
+	{
+		auto& Cell = Cells[Pos % Capacity];
+		auto Sequence = Cell.Sequence.load(std::memory_order_acquire);
+		auto Diff = static_cast<int64>(Sequence - Pos);
+		if (Diff == 0)
+		{
+			if (SendPos.compare_exchange_weak(Pos, Pos + 1,
+			                                  std::memory_order_relaxed))
+			{
+				new (&Cell.Storage) T(std::move(Value));
+				Cell.Sequence.store(Pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (Diff < 0)
+			return false; // Full, or the receiver of this cell is still busy
+		else
+			Pos = SendPos.load(std::memory_order_relaxed);
+	}
+}
+
+template<typename T>
+bool UE5Coro::TChannel<T>::TryPopValue(TOptional<T>& Value)
+{
+	for (auto Pos = ReceivePos.load(std::memory_order_relaxed);;)
+	{
+		auto& Cell = Cells[Pos % Capacity];
+		auto Sequence = Cell.Sequence.load(std::memory_order_acquire);
+		auto Diff = static_cast<int64>(Sequence - (Pos + 1));
+		if (Diff == 0)
+		{
+			if (ReceivePos.compare_exchange_weak(Pos, Pos + 1,
+			                                     std::memory_order_relaxed))
+			{
+				T* Item = Cell.Storage.GetTypedPtr();
+				Value.Emplace(std::move(*Item));
+				Item->~T();
+				Cell.Sequence.store(Pos + Capacity, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (Diff < 0)
+			return false; // Empty, or the sender of this cell is still busy
+		else
+			Pos = ReceivePos.load(std::memory_order_relaxed);
+	}
+}
+
+template<typename T>
+bool UE5Coro::TChannel<T>::TryPush(void* Item)
+{
+	return TryPushValue(*static_cast<T*>(Item));
+}
+
+template<typename T>
+bool UE5Coro::TChannel<T>::TryPop(void* Item)
+{
+	return TryPopValue(*static_cast<TOptional<T>*>(Item));
+}
+
+template<typename T>
+TArray<T> UE5Coro::Private::TChannelReceiveManyAwaiter<T>::await_resume()
+{
+	TArray<T> Values;
+	if (!this->Value)
+		return Values; // Closed and drained
+	Values.Add(std::move(*this->Value));
+
+	auto& TypedChannel = static_cast<TChannel<T>&>(this->Channel);
+	for (TOptional<T> Next; Values.Num() < MaxCount &&
+	                        TypedChannel.TryPopValue(Next); Next.Reset())
+		Values.Add(std::move(*Next));
+	if (Values.Num() > 1)
+		TypedChannel.Notify(false);
+	return Values;
+}
+#pragma endregion
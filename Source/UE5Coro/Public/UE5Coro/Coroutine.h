@@ -53,6 +53,11 @@ class UE5CORO_API TCoroutine<>
 {
 	template<typename, typename, typename>
 	friend class Private::TCoroutinePromise;
+	friend Private::FAdmissionControl;
+	friend Private::FAggregateAwaiter;
+	friend Private::FCancellationState;
+	friend Private::FCoroutineGroupState;
+	friend Private::FLatentCoroutineAwaiter;
 	friend std::hash<TCoroutine>;
 
 protected:
@@ -77,7 +82,9 @@ public:
 	[[nodiscard]] static TCoroutine<T> FromFailure();
 
 	/** Request the coroutine to stop executing at the next opportunity.
-	 *  This function returns immediately, with the coroutine still running.
+	 *  This function returns immediately, with the coroutine still running,
+	 *  except for latent coroutines awaiting a TLatentAwaiter: if called on the
+	 *  game thread, these are destroyed before this function returns.
 	 *  Has no effect on coroutines that have already completed. */
 	void Cancel();
 
@@ -60,8 +60,12 @@ private:
 
 class UE5CORO_API FLatentCoroutineAwaiter : public FLatentAwaiter
 {
+	static bool ShouldResume(void*, bool);
+
 protected:
+	TCoroutine<> Antecedent;
 	explicit FLatentCoroutineAwaiter(TCoroutine<>&& Antecedent);
+	FLatentCoroutineAwaiter(FLatentCoroutineAwaiter&&) noexcept;
 };
 
 template<typename T, bool bMove>
@@ -93,21 +97,19 @@ struct TLatentCoroutineAwaiter final : FLatentCoroutineAwaiter
 
 	T await_resume()
 	{
-		auto* Coro = static_cast<TCoroutine<T>*>(State);
-		checkf(Coro->IsDone(), TEXT("Internal error: resuming too early"));
+		checkf(Antecedent.IsDone(), TEXT("Internal error: resuming too early"));
+		auto& AntecedentT = static_cast<TCoroutine<T>&>(Antecedent);
+
 		if constexpr (!std::is_void_v<T>)
 		{
 			if constexpr (bMove) // This cannot be a ternary due to RVO rules
-				return Coro->MoveResult();
+				return AntecedentT.MoveResult();
 			else
-				return Coro->GetResult();
+				return AntecedentT.GetResult();
 		}
 	}
 };
 
-static_assert(sizeof(TLatentCoroutineAwaiter<FTransform, false>) ==
-              sizeof(FLatentAwaiter));
-
 template<typename T>
 auto TAwaitTransform<FAsyncPromise, TCoroutine<T>>::operator()(
 	const TCoroutine<T>& Coro) -> TAsyncCoroutineAwaiter<T, false>
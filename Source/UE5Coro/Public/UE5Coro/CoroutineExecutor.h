@@ -0,0 +1,115 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include <atomic>
+#include <memory>
+#include "UE5Coro/Private.h"
+#include "UE5Coro/Promise.h"
+
+namespace UE5Coro
+{
+/** Pool of worker threads that are dedicated to resuming coroutines.
+ *  Each worker has its own work-stealing queue, and idle workers take
+ *  coroutines from busy ones. Scheduling a coroutine does not allocate. */
+class UE5CORO_API FCoroutineExecutor final
+{
+	friend Private::FExecutorAwaiter;
+	friend Private::FExecutorWorker;
+
+	// Lock-free LIFO of promises from threads outside this executor,
+	// linked through FPromise::ScheduleNext
+	std::atomic<Private::FPromise*> Injected = nullptr;
+	UE::FMutex Lock; // Guards Idle
+	TArray<Private::FExecutorWorker*> Idle;
+	std::atomic<int32> NumIdle = 0;
+	std::atomic<bool> bStopping = false;
+	TArray<std::unique_ptr<Private::FExecutorWorker>> Workers;
+
+public:
+	/** Starts the given number of worker threads, or one per CPU core if
+	 *  NumWorkers is not positive. */
+	explicit FCoroutineExecutor(int32 NumWorkers = 0,
+	                            EThreadPriority Priority = TPri_Normal);
+	UE_NONCOPYABLE(FCoroutineExecutor);
+
+	/** Lets coroutines that are already scheduled on this executor run until
+	 *  they leave it or suspend, then stops the worker threads.
+	 *  Scheduling new coroutines from outside the executor is not allowed
+	 *  while this is running. */
+	~FCoroutineExecutor();
+
+	/** Returns the default executor, which has one worker per CPU core. */
+	static FCoroutineExecutor& Get();
+
+	/** Returns the number of worker threads of this executor. */
+	[[nodiscard]] int32 GetNumWorkers() const noexcept;
+
+private:
+	void Schedule(Private::FPromise&);
+	void WakeOne();
+	[[nodiscard]] bool HasWork() const;
+	[[nodiscard]] Private::FPromise* TakeInjected(Private::FExecutorWorker&);
+	[[nodiscard]] Private::FPromise* Steal(Private::FExecutorWorker&);
+};
+}
+
+namespace UE5Coro::Async
+{
+/** Returns an object that, when co_awaited, unconditionally suspends the
+ *  calling coroutine, and resumes it on one of the executor's worker threads.
+ *
+ *  The return value of this function is reusable. Repeated co_awaits will keep
+ *  moving back into the same executor. */
+UE5CORO_API auto MoveToExecutor(
+	FCoroutineExecutor& Executor = FCoroutineExecutor::Get()) noexcept
+	-> Private::FExecutorAwaiter;
+}
+
+#pragma region Private
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FExecutorAwaiter final
+	: public TAwaiter<FExecutorAwaiter>
+{
+	FCoroutineExecutor& Executor;
+
+public:
+	explicit FExecutorAwaiter(FCoroutineExecutor& Executor) noexcept
+		: Executor(Executor) { }
+
+	void Suspend(FPromise&);
+};
+}
+#pragma endregion
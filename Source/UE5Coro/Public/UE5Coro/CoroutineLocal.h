@@ -0,0 +1,82 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+#include "UE5Coro/Coroutine.h"
+
+namespace UE5Coro
+{
+/** Per-coroutine storage for a value of type T, which will be default
+ *  constructed the first time it's accessed by a coroutine, and destroyed when
+ *  that coroutine is.
+ *  Values are owned by the coroutine, and follow it across threads. They're
+ *  stored in place in a block that the coroutine allocates the first time it
+ *  accesses any TCoroutineLocal. References to them remain valid until they're
+ *  destroyed.
+ *  Objects of this type are meant to have static storage duration, each one
+ *  permanently reserves a slot and sizeof(T) bytes in every such block.
+ *  Members are only valid to call from within a coroutine returning TCoroutine,
+ *  and they will access the currently-executing coroutine's value. */
+template<typename T>
+class TCoroutineLocal final
+{
+	static_assert(std::is_default_constructible_v<T>,
+	              "Coroutine locals are lazily default constructed");
+
+	const Private::FCoroutineLocalSlot Slot;
+
+public:
+	TCoroutineLocal()
+		: Slot(Private::AllocateCoroutineLocalSlot(sizeof(T), alignof(T))) { }
+	UE_NONCOPYABLE(TCoroutineLocal);
+
+	/** Returns this coroutine's value, constructing it if needed. */
+	[[nodiscard]] T& Get() const
+	{
+		return Private::FPromise::Current().GetLocal<T>(Slot);
+	}
+
+	/** Returns this coroutine's value, or nullptr if it doesn't exist yet. */
+	[[nodiscard]] T* TryGet() const
+	{
+		return Private::FPromise::Current().FindLocal<T>(Slot);
+	}
+
+	/** Destroys this coroutine's value. The next Get will construct a new one. */
+	void Reset() const { Private::FPromise::Current().ResetLocal(Slot); }
+
+	T& operator*() const { return Get(); }
+	T* operator->() const { return &Get(); }
+};
+}
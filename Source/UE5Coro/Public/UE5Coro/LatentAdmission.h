@@ -0,0 +1,97 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definition.h"
+
+namespace UE5Coro
+{
+/** Determines what happens to a latent coroutine that would exceed its owner's
+ *  admission limit when it's started. */
+enum class EAdmissionPolicy : uint8
+{
+	/** The coroutine is suspended before running anything, and it will start
+	 *  on the game thread when one of the owner's coroutines completes. */
+	Queue,
+	/** The coroutine does not run, and it completes unsuccessfully before the
+	 *  call that started it returns, like TCoroutine<>::FailedCoroutine. */
+	Reject,
+	/** The owner's oldest live coroutine is canceled to make room. */
+	CancelOldest,
+};
+
+/** Statistics about an owner's latent coroutines. */
+struct FAdmissionCounters
+{
+	/** Number of coroutines that are currently running. */
+	int32 Live = 0;
+	/** Number of coroutines that are currently waiting to start. */
+	int32 Queued = 0;
+	/** Total number of coroutines that were allowed to run. */
+	int64 Admitted = 0;
+	/** Total number of coroutines that were not started. */
+	int64 Rejected = 0;
+	/** Total number of coroutines that were canceled to make room. */
+	int64 Evicted = 0;
+};
+}
+
+namespace UE5Coro::Latent
+{
+/** Limits the number of live latent coroutines that have Owner as their latent
+ *  callback target (this is usually the object that they're running on).
+ *  A negative MaxLive removes the limit, and starts every queued coroutine.
+ *  Object limits take precedence over class limits.
+ *  Game thread only. */
+UE5CORO_API void SetAdmissionLimit(const UObject* Owner, int32 MaxLive,
+                                   EAdmissionPolicy Policy);
+
+/** Limits the number of live latent coroutines that have an instance of Class
+ *  as their latent callback target. Subclasses are not affected.
+ *  A negative MaxLive removes the limit, and starts every queued coroutine.
+ *  Game thread only. */
+UE5CORO_API void SetClassAdmissionLimit(const UClass* Class, int32 MaxLive,
+                                        EAdmissionPolicy Policy);
+
+/** Returns statistics about Owner's latent coroutines.
+ *  Only coroutines started while a limit was set for Owner are counted.
+ *  Game thread only. */
+[[nodiscard]] UE5CORO_API FAdmissionCounters GetAdmissionCounters(
+	const UObject* Owner);
+
+/** Returns statistics about latent coroutines owned by instances of Class.
+ *  Only coroutines started while a limit was set for Class are counted.
+ *  Game thread only. */
+[[nodiscard]] UE5CORO_API FAdmissionCounters GetClassAdmissionCounters(
+	const UClass* Class);
+}
@@ -47,6 +47,11 @@
 
 struct FForceLatentCoroutine;
 class UUE5CoroAnimCallbackTarget;
+namespace UE5Coro
+{
+class FCoroutineExecutor;
+}
+
 namespace UE5Coro::Private
 {
 // Default passthrough
@@ -74,43 +79,91 @@ struct TAwaitTransform
 
 extern thread_local bool GDestroyedEarly;
 enum class ELatentExitReason : uint8;
+class FAdmissionControl;
+class FAggregateAwaiter;
 class FAllAwaiter;
+class FAllResultsAwaiter;
 class FAnyAwaiter;
 class FAsyncAwaiter;
+class FAsyncFrameAwaiter;
+class FAsyncGeneratorNextAwaiter;
+class FAsyncGeneratorState;
+class FAsyncGeneratorYieldAwaiter;
 struct FAsyncPreloadAwaiter;
 class FAsyncPromise;
 class FAsyncTimeAwaiter;
 class FAsyncYieldAwaiter;
+class FAwaitableFutureAwaiter;
+class FAwaitableStateBase;
+class FBarrierAwaiter;
+class FBlockingPoolAwaiter;
+class FBlockingPoolWorker;
+class FBroadcastChannelBase;
+class FBroadcastNextAwaiter;
+class FBroadcastPublishAwaiter;
 class FCancellationAwaiter;
+struct FCancellationNode;
+class FCancellationState;
+class FChannelAwaiter;
+class FChannelBase;
+struct FContinuationNode;
+class FCoroutineGroupState;
+struct FCoroutineLocalBlock;
 struct FCustomTimeDilationAwaiter;
 class FEventAwaiter;
+class FExecutorAwaiter;
+class FExecutorWorker;
+class FForEachConcurrentAwaiter;
+class FForEachConcurrentState;
+class FGameThreadInbox;
+class FGroupJoinAwaiter;
+struct FGroupNode;
 class FHttpAwaiter;
+class FLatchAwaiter;
 class FLatentChainAwaiter;
 class FLatentAnyAwaiter;
 class FLatentAwaiter;
+class FLatentCoroutineAwaiter;
 class FLatentPromise;
+class FLinkCancellationAwaiter;
 struct FManualCoroutineOverride { };
+class FMutexLockAwaiter;
 class FNewThreadAwaiter;
 struct FPackageLoadAwaiter;
 class FPromise;
 struct FPromiseExtras;
 class FRaceAwaiter;
+class FRWLockAwaiter;
 class FSemaphoreAwaiter;
 class FTaskAwaiter;
 class FThreadPoolAwaiter;
+class FTimerThread;
 class FTwoLives;
 struct FNonCancelable;
 namespace Debug { class FUE5CoroCategory; }
 namespace Test { class FTestHelper; }
+template<typename> class TAllResultsArrayAwaiter;
+template<typename...> class TAllResultsAwaiter;
 template<typename> struct TAnimAwaiter;
+template<typename> class TAsyncGeneratorNextAwaiter;
+template<typename> class TAsyncGeneratorPromise;
+template<typename> class TAsyncGeneratorState;
 template<typename, int> struct TAsyncLoadAwaiter;
 template<typename> struct TAsyncQueryAwaiter;
 template<typename> struct TAsyncQueryAwaiterRV;
+template<typename, bool> class TAwaitableFutureAwaiter;
+template<typename> class TAwaitableState;
+template<typename> class TBroadcastNextAwaiter;
+template<typename> class TBroadcastPublishAwaiter;
 template<typename> class TCancelableAwaiter;
+template<typename> class TChannelReceiveAwaiter;
+template<typename> class TChannelReceiveManyAwaiter;
+template<typename> class TChannelSendAwaiter;
 template<typename, typename, typename> class TCoroutinePromise;
 template<bool, typename, typename, typename...> class TDelegateAwaiter;
 template<bool, typename, typename> struct TDelegateAwaiterFor;
 template<bool, typename, typename, typename...> class TDynamicDelegateAwaiter;
+template<typename, typename> class TForEachConcurrentState;
 template<typename> class TFutureAwaiter;
 template<typename> class TGeneratorPromise;
 template<typename> class TManualPromiseExtras;
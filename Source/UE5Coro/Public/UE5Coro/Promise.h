@@ -137,6 +137,8 @@ struct FInitialSuspend final
 	{
 		Resume,
 		Destroy,
+		Defer,
+		Fail,
 	} Action;
 
 	[[nodiscard]] bool await_ready() noexcept { return false; }
@@ -150,6 +152,10 @@ struct FInitialSuspend final
 			case Resume: Handle.promise().ResumeFast(); break;
 			// This is very early and doesn't yet count as cancellation
 			case Destroy: Handle.destroy(); break;
+			// Something else will resume the coroutine later
+			case Defer: break;
+			// Like Destroy, but the coroutine is reported as unsuccessful
+			case Fail: GDestroyedEarly = true; Handle.destroy(); break;
 		}
 	}
 
@@ -172,6 +178,38 @@ struct FLatentFinalSuspend final
 	void await_resume() noexcept { }
 };
 
+// Intrusive alternative to std::function continuations, for internal callers
+// that already own storage that outlives the coroutine.
+// Fn is called once with the return value pointer, after which Fn may free the
+// node. Completion order relative to other continuations is unspecified.
+struct FContinuationNode
+{
+	void (*Fn)(FContinuationNode*, void*) = nullptr;
+	FContinuationNode* Next = nullptr;
+};
+
+// Membership of a promise in an FCoroutineGroup.
+// The links are guarded by the group's lock. Allocated when the promise joins
+// the group, and freed when it leaves.
+struct FGroupNode final : FContinuationNode
+{
+	FPromise* Promise = nullptr;
+	FCoroutineGroupState* Group = nullptr;
+	FGroupNode* GroupPrev = nullptr;
+	FGroupNode* GroupNext = nullptr;
+};
+
+// Link of a promise to an FCancellationSource.
+// The links are guarded by both the source's and the promise's lock.
+// Allocated when the promise is first linked, and freed when it completes.
+struct FCancellationNode final : FContinuationNode
+{
+	FPromise* Promise = nullptr;
+	std::shared_ptr<FCancellationState> State; // Not linked if nullptr
+	FCancellationNode* LinkPrev = nullptr;
+	FCancellationNode* LinkNext = nullptr;
+};
+
 /** Fields of FPromise that may be alive after the coroutine is done. */
 struct [[nodiscard]] UE5CORO_API FPromiseExtras
 {
@@ -190,6 +228,8 @@ struct [[nodiscard]] UE5CORO_API FPromiseExtras
 	FEventRef Completed{EEventMode::ManualReset};
 	// This could be read from another thread
 	std::atomic<bool> bWasSuccessful = false;
+	// Set after Completed is triggered, polling this is much cheaper
+	std::atomic<bool> bDone = false;
 
 	UE::FMutex Lock; // Used for the union below and by FLatentPromise
 	union
@@ -204,6 +244,8 @@ struct [[nodiscard]] UE5CORO_API FPromiseExtras
 
 	bool IsComplete() const;
 	template<typename T> void ContinueWith(auto Fn);
+	// Returns false without adding Node if the coroutine has already completed
+	[[nodiscard]] bool TryAddContinuation(FContinuationNode& Node);
 };
 
 template<typename T>
@@ -233,7 +275,92 @@ public:
 	}
 };
 
+// Where a TCoroutineLocal's value lives in every coroutine's storage.
+// Offsets are global, every slot has its own range of bytes.
+struct FCoroutineLocalSlot final
+{
+	int32 Index;
+	uint32 Offset;
+};
+UE5CORO_API FCoroutineLocalSlot AllocateCoroutineLocalSlot(size_t Size,
+                                                           size_t Alignment);
+
+// Intrusive link embedded in awaiters that suspend in an FWaitQueue.
+// Guarded by the lock of the object that owns the queue.
+struct FWaitNode
+{
+	FPromise* Promise = nullptr;
+	// Called instead of resuming Promise if set, false means the wait gave up
+	bool (*Callback)(FWaitNode&, bool bDispatch) = nullptr;
+	FWaitNode* Prev = nullptr;
+	FWaitNode* Next = nullptr;
+	bool bQueued = false;
+};
+
+// Allocation-free FIFO of suspended awaiters with O(1) removal.
+// The nodes live in the awaiters, which live in the suspended coroutine frames.
+class FWaitQueue final
+{
+	FWaitNode* Head = nullptr;
+	FWaitNode* Tail = nullptr;
+
+public:
+	[[nodiscard]] bool IsEmpty() const noexcept { return !Head; }
+
+	void PushBack(FWaitNode& Node) noexcept
+	{
+		checkf(!Node.bQueued, TEXT("Internal error: node already queued"));
+		Node.Prev = Tail;
+		Node.Next = nullptr;
+		Node.bQueued = true;
+		(Tail ? Tail->Next : Head) = &Node;
+		Tail = &Node;
+	}
+
+	void PushFront(FWaitNode& Node) noexcept
+	{
+		checkf(!Node.bQueued, TEXT("Internal error: node already queued"));
+		Node.Prev = nullptr;
+		Node.Next = Head;
+		Node.bQueued = true;
+		(Head ? Head->Prev : Tail) = &Node;
+		Head = &Node;
+	}
+
+	[[nodiscard]] FWaitNode* PopFront() noexcept
+	{
+		auto* Node = Head;
+		if (Node)
+			Remove(*Node);
+		return Node;
+	}
+
+	/** Returns false if the node was not in the queue. */
+	bool Remove(FWaitNode& Node) noexcept
+	{
+		if (!Node.bQueued)
+			return false;
+		(Node.Prev ? Node.Prev->Next : Head) = Node.Next;
+		(Node.Next ? Node.Next->Prev : Tail) = Node.Prev;
+		Node.Prev = nullptr;
+		Node.Next = nullptr;
+		Node.bQueued = false;
+		return true;
+	}
+
+	/** Empties the queue, and returns its nodes as a list linked by Next.
+	 *  Removing them from this queue has no effect afterwards. */
+	[[nodiscard]] FWaitNode* TakeAll() noexcept
+	{
+		for (auto* Node = Head; Node; Node = Node->Next)
+			Node->bQueued = false;
+		Tail = nullptr;
+		return std::exchange(Head, nullptr);
+	}
+};
+
 extern thread_local FPromise* GCurrentPromise;
+extern thread_local int GCancelableAwaiterDepth;
 UE5CORO_API extern UWorldProxy GCurrentCoroWorld;
 inline UWorld* GetBestWorld()
 {
@@ -245,10 +372,26 @@ class [[nodiscard]] UE5CORO_API FPromise
 {
 	friend void TCoroutine<>::SetDebugName(FString);
 	template<typename T> friend class TManualPromiseExtras;
+	friend FCancellationState;
+	friend FCoroutineGroupState;
 	friend FCoroutineScope;
+	friend FGameThreadInbox;
+	friend UE5Coro::FCoroutineExecutor;
 	friend Debug::FUE5CoroCategory;
 
 	FCancellationTracker CancellationTracker;
+	// Intrusive link for the scheduler that will resume this promise next.
+	// Used by FGameThreadInbox and FCoroutineExecutor's injected coroutines,
+	// a promise is waiting to be resumed by at most one of them at a time.
+	FPromise* ScheduleNext = nullptr;
+	// Promises are in at most one FCoroutineGroup, nullptr if not in one
+	FGroupNode* GroupNode = nullptr;
+	// Promises are linked to at most one FCancellationSource at a time,
+	// nullptr if they were never linked to one
+	FCancellationNode* CancellationNode = nullptr;
+	// Storage for TCoroutineLocal values, only used by the coroutine itself.
+	// Allocated on first use, nullptr if the coroutine never used locals.
+	FCoroutineLocalBlock* Locals = nullptr;
 
 protected:
 	// Latent promises always have a home world.
@@ -258,16 +401,24 @@ protected:
 
 	std::shared_ptr<FPromiseExtras> Extras;
 	std::vector<std::function<void(void*)>> OnCompleted;
+	FContinuationNode* OnCompletedNodes = nullptr;
 #if !PLATFORM_EXCEPTIONS_DISABLED
 	std::atomic<bool> bUnhandledException = false;
 #endif
 
+private:
+	// Set along with ScheduleNext by FGameThreadInbox, next to the other flag
+	// to share its padding
+	bool bInboxDestroy = false;
+
+protected:
 	explicit FPromise(std::shared_ptr<FPromiseExtras>, const TCHAR* PromiseType);
 	UE_NONCOPYABLE(FPromise);
 	virtual ~FPromise(); // Virtual for warning suppression only
 	void ResumeInternal(bool bBypassCancellationHolds);
 	virtual bool IsEarlyDestroy() const = 0;
 	virtual void ThreadSafeDestroy();
+	virtual void ExpediteCancellation() { }
 
 public:
 	static FPromise& Current();
@@ -283,6 +434,15 @@ public:
 	virtual void Resume();
 	void ResumeFast();
 	void AddContinuation(std::function<void(void*)>);
+	void AddContinuation(FContinuationNode&);
+	template<typename T> [[nodiscard]] T& GetLocal(FCoroutineLocalSlot);
+	template<typename T> [[nodiscard]] T* FindLocal(FCoroutineLocalSlot) const;
+	[[nodiscard]] void* FindLocalValue(FCoroutineLocalSlot) const;
+	[[nodiscard]] void* ConstructLocal(FCoroutineLocalSlot,
+	                                   void (*Construct)(void*),
+	                                   void (*Destroy)(void*));
+	void ResetLocal(FCoroutineLocalSlot);
+	void DestroyLocals();
 
 	void unhandled_exception();
 
@@ -295,6 +455,23 @@ public:
 #endif
 };
 
+template<typename T>
+T& FPromise::GetLocal(FCoroutineLocalSlot Slot)
+{
+	if (auto* Value = FindLocal<T>(Slot)) [[likely]]
+		return *Value;
+
+	return *static_cast<T*>(ConstructLocal(Slot,
+		[](void* Ptr) { new (Ptr) T(); },
+		[](void* Ptr) { static_cast<T*>(Ptr)->~T(); }));
+}
+
+template<typename T>
+T* FPromise::FindLocal(FCoroutineLocalSlot Slot) const
+{
+	return static_cast<T*>(FindLocalValue(Slot));
+}
+
 class [[nodiscard]] UE5CORO_API FAsyncPromise : public FPromise
 {
 protected:
@@ -349,8 +526,10 @@ protected:
 	virtual ~FLatentPromise() override;
 	virtual bool IsEarlyDestroy() const override;
 	virtual void ThreadSafeDestroy() final override;
+	virtual void ExpediteCancellation() override;
 
 public:
+	static void ProcessExpeditedCancellations();
 	virtual void Resume() override;
 	void LatentActionDestroyed();
 	void CancelFromWithin();
@@ -384,6 +563,7 @@ public:
 
 	~TCoroutinePromise()
 	{
+		this->DestroyLocals(); // These might take locks of their own
 		auto* ExtrasT = static_cast<Extras*>(this->Extras.get());
 		ExtrasT->Lock.Lock(); // This will be held until the end of ~FPromise
 		checkf(ExtrasT->Promise, TEXT("Unexpected double promise destruction"));
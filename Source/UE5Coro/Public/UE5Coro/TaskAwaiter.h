@@ -36,15 +36,40 @@
 #include "Tasks/Task.h"
 #include "UE5Coro/Promise.h"
 
+namespace UE5Coro::Async
+{
+/** Returns an object that, when co_awaited, waits for the task to complete,
+ *  then resumes the coroutine with the given priorities, similarly to
+ *  MoveToTask. The result of the await expression is the task's result.
+ *
+ *  co_awaiting a TTask directly uses EExtendedTaskPriority::Inline, which
+ *  resumes the coroutine on the thread that completed the task, right after
+ *  it's done, without waiting for another task to be scheduled.
+ *  If the task is already complete, the coroutine continues synchronously. */
+template<typename T>
+auto AwaitTask(UE::Tasks::TTask<T> Task,
+               UE::Tasks::ETaskPriority Priority,
+               UE::Tasks::EExtendedTaskPriority ExtendedPriority =
+                   UE::Tasks::EExtendedTaskPriority::None)
+	-> Private::TTaskAwaiter<T>;
+}
+
+#pragma region Private
 namespace UE5Coro::Private
 {
 class [[nodiscard]] UE5CORO_API FTaskAwaiter : public TAwaiter<FTaskAwaiter>
 {
 	const TCHAR* DebugName;
+	UE::Tasks::ETaskPriority Priority;
+	UE::Tasks::EExtendedTaskPriority ExtendedPriority;
 
 public:
-	explicit FTaskAwaiter(const TCHAR* DebugName) noexcept
-		: DebugName(DebugName) { }
+	explicit FTaskAwaiter(const TCHAR* DebugName,
+	                      UE::Tasks::ETaskPriority Priority,
+	                      UE::Tasks::EExtendedTaskPriority ExtendedPriority)
+		noexcept
+		: DebugName(DebugName), Priority(Priority),
+		  ExtendedPriority(ExtendedPriority) { }
 
 	void Suspend(FPromise& Promise);
 };
@@ -54,16 +79,23 @@ class [[nodiscard]] TTaskAwaiter : public TAwaiter<TTaskAwaiter<T>>
 {
 	UE::Tasks::TTask<T> Task;
 	const TCHAR* DebugName;
+	UE::Tasks::ETaskPriority Priority;
+	UE::Tasks::EExtendedTaskPriority ExtendedPriority;
 
 public:
-	explicit TTaskAwaiter(UE::Tasks::TTask<T> Task, const TCHAR* DebugName)
-		: Task(Task), DebugName(DebugName) { }
+	explicit TTaskAwaiter(UE::Tasks::TTask<T> Task, const TCHAR* DebugName,
+	                      UE::Tasks::ETaskPriority Priority,
+	                      UE::Tasks::EExtendedTaskPriority ExtendedPriority)
+		: Task(Task), DebugName(DebugName), Priority(Priority),
+		  ExtendedPriority(ExtendedPriority) { }
 
 	[[nodiscard]] bool await_ready() { return Task.IsCompleted(); }
 
 	void Suspend(FPromise& Promise)
 	{
-		UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); }, Task);
+		// Inline runs this as soon as Task completes, on the same thread
+		UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); }, Task,
+		                  Priority, ExtendedPriority);
 	}
 
 	decltype(auto) await_resume()
@@ -78,7 +110,21 @@ struct TAwaitTransform<P, UE::Tasks::TTask<T>>
 {
 	TTaskAwaiter<T> operator()(UE::Tasks::TTask<T> Task)
 	{
-		return TTaskAwaiter<T>(Task, TEXT("UE5Coro implicit co_await wrapper"));
+		return TTaskAwaiter<T>(Task, TEXT("UE5Coro implicit co_await wrapper"),
+		                       UE::Tasks::ETaskPriority::Normal,
+		                       UE::Tasks::EExtendedTaskPriority::Inline);
 	}
 };
 }
+
+template<typename T>
+auto UE5Coro::Async::AwaitTask(UE::Tasks::TTask<T> Task,
+                               UE::Tasks::ETaskPriority Priority,
+                               UE::Tasks::EExtendedTaskPriority ExtendedPriority)
+	-> Private::TTaskAwaiter<T>
+{
+	return Private::TTaskAwaiter<T>(std::move(Task),
+	                                TEXT("UE5Coro::Async::AwaitTask"), Priority,
+	                                ExtendedPriority);
+}
+#pragma endregion
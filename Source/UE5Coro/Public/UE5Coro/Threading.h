@@ -33,7 +33,8 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definition.h"
-#include <forward_list>
+#include <atomic>
+#include <functional>
 #include "UE5Coro/Private.h"
 #include "UE5Coro/Promise.h"
 
@@ -44,13 +45,14 @@ namespace UE5Coro
  *  AutoReset events will only resume one awaiter, ManualReset all of them. */
 class UE5CORO_API FAwaitableEvent final
 {
+	friend Private::FAggregateAwaiter;
 	friend Private::FEventAwaiter;
 	friend Private::Test::FTestHelper;
 
 	UE::FMutex Lock;
 	bool bActive;
 	const EEventMode Mode;
-	std::forward_list<Private::FPromise*> AwaitingPromises;
+	Private::FWaitQueue Waiters;
 
 public:
 	/** Initializes this event to be in the given mode and state. */
@@ -71,27 +73,45 @@ public:
 	auto operator co_await() -> Private::FEventAwaiter;
 
 private:
-	[[nodiscard]] bool TryResumeOne();
+	void TryResumeOne();
 	void TryResumeAll();
 };
 
+/** Options that change how FAwaitableSemaphore resumes its awaiters. */
+enum class ESemaphoreFlags : uint8
+{
+	None = 0,
+	/** Counts released by Unlock() are transferred directly to awaiting
+	 *  coroutines, instead of being available to anyone that co_awaits the
+	 *  semaphore while earlier awaiters are being resumed. */
+	Handoff = 1 << 0,
+	/** Unlock() takes every coroutine that it can resume at once, and schedules
+	 *  them on the task graph in at most one task per worker thread, instead of
+	 *  running them one after the other on the unlocking thread. */
+	DispatchWakes = 1 << 1,
+};
+ENUM_CLASS_FLAGS(ESemaphoreFlags)
+
 /** Awaitable semaphore. co_awaiting this object will attempt to lock/acquire
  *  one count and suspend the coroutine if this was not possible, resuming it
  *  when the semaphore is next Unlock()ed (released). */
 class UE5CORO_API FAwaitableSemaphore final
 {
+	friend Private::FAggregateAwaiter;
 	friend Private::FSemaphoreAwaiter;
 	friend Private::Test::FTestHelper;
 
 	UE::FMutex Lock;
 	const int Capacity;
 	int Count;
-	std::forward_list<Private::FPromise*> AwaitingPromises;
+	const ESemaphoreFlags Flags;
+	Private::FWaitQueue Waiters;
 
 public:
 	/** Initializes the semaphore to the given capacity and initial count.
 	 *  Defaults to being an unlocked mutex. */
-	explicit FAwaitableSemaphore(int Capacity = 1, int InitialCount = 1);
+	explicit FAwaitableSemaphore(int Capacity = 1, int InitialCount = 1,
+	                             ESemaphoreFlags Flags = ESemaphoreFlags::None);
 	UE_NONCOPYABLE(FAwaitableSemaphore);
 #if UE5CORO_DEBUG
 	~FAwaitableSemaphore();
@@ -105,15 +125,302 @@ public:
 private:
 	void TryResumeAll();
 };
+
+/** Awaitable mutex. co_awaiting Lock() acquires it, and results in a guard
+ *  object that unlocks it when destroyed.
+ *  Locking and unlocking without contention is a single atomic operation.
+ *  Unlocking with coroutines waiting passes ownership directly to the one that
+ *  has been waiting the longest, and resumes it on the unlocking thread. */
+class UE5CORO_API FAwaitableMutex final
+{
+	friend Private::FMutexLockAwaiter;
+	friend Private::Test::FTestHelper;
+
+	static constexpr uint8 Locked = 1;
+	static constexpr uint8 Contended = 2; // Waiters might be queued
+
+	std::atomic<uint8> State = 0;
+	UE::FMutex QueueLock;
+	Private::FWaitQueue Waiters;
+
+public:
+	/** Move-only object representing ownership of a locked FAwaitableMutex.
+	 *  The mutex is unlocked when this object is destroyed, including when
+	 *  its coroutine is canceled or destroyed. */
+	class UE5CORO_API FGuard final
+	{
+		friend FAwaitableMutex;
+		friend Private::FMutexLockAwaiter;
+
+		FAwaitableMutex* Mutex;
+
+		explicit FGuard(FAwaitableMutex* Mutex) noexcept : Mutex(Mutex) { }
+
+	public:
+		FGuard(FGuard&& Other) noexcept
+			: Mutex(std::exchange(Other.Mutex, nullptr)) { }
+		FGuard& operator=(FGuard&&) noexcept;
+		~FGuard();
+
+		/** Unlocks the mutex early, if this object owns it. */
+		void Unlock();
+		/** @return true if this object is responsible for unlocking a mutex. */
+		[[nodiscard]] bool OwnsLock() const noexcept { return Mutex != nullptr; }
+		explicit operator bool() const noexcept { return OwnsLock(); }
+	};
+
+	FAwaitableMutex() = default;
+	UE_NONCOPYABLE(FAwaitableMutex);
+#if UE5CORO_DEBUG
+	~FAwaitableMutex();
+#endif
+
+	/** Returns an object that, when co_awaited, locks this mutex, suspending
+	 *  the coroutine until that's possible. The result of the co_await
+	 *  expression is an FGuard that owns the lock. */
+	[[nodiscard]] auto Lock() noexcept -> Private::FMutexLockAwaiter;
+
+	/** Attempts to lock this mutex without waiting.
+	 *  @return A guard that owns the lock on success, an empty one otherwise. */
+	[[nodiscard]] FGuard TryLock() noexcept;
+
+private:
+	[[nodiscard]] bool TryLockFast() noexcept;
+	void Unlock();
+};
+
+/** Determines which side FAwaitableRWLock favors when both readers and writers
+ *  are waiting for it. */
+enum class ERWLockPolicy : uint8
+{
+	/** New readers wait behind writers that are already waiting, even if the
+	 *  lock is currently held by other readers. Writers cannot be starved. */
+	PreferWriters,
+	/** New readers join the current readers while writers are waiting.
+	 *  Writers only get the lock once there are no readers left. */
+	PreferReaders,
+};
+
+/** Awaitable reader-writer lock. Any number of coroutines may hold it for
+ *  reading at the same time, or a single one for writing.
+ *  co_awaiting ReadLock() or WriteLock() results in a guard object that unlocks
+ *  it when destroyed. Uncontended locking and unlocking are single atomic
+ *  operations on a reader count.
+ *  When the lock is released, ownership is passed directly to the next writer,
+ *  or to every waiting reader at once, depending on the policy. */
+class UE5CORO_API FAwaitableRWLock final
+{
+	friend Private::FRWLockAwaiter;
+	friend Private::Test::FTestHelper;
+
+	static constexpr uint32 Writer = 1u << 31;
+	static constexpr uint32 Contended = 1u << 30; // Waiters might be queued
+	static constexpr uint32 Readers = Contended - 1;
+
+	std::atomic<uint32> State = 0;
+	const ERWLockPolicy Policy;
+	UE::FMutex QueueLock;
+	Private::FWaitQueue ReadWaiters;
+	Private::FWaitQueue WriteWaiters;
+
+public:
+	/** Move-only object representing shared or exclusive ownership of a locked
+	 *  FAwaitableRWLock. The lock is released when this object is destroyed,
+	 *  including when its coroutine is canceled or destroyed. */
+	class UE5CORO_API FGuard final
+	{
+		friend FAwaitableRWLock;
+		friend Private::FRWLockAwaiter;
+
+		FAwaitableRWLock* Lock;
+		bool bWrite;
+
+		explicit FGuard(FAwaitableRWLock* Lock, bool bWrite) noexcept
+			: Lock(Lock), bWrite(bWrite) { }
+
+	public:
+		FGuard(FGuard&& Other) noexcept
+			: Lock(std::exchange(Other.Lock, nullptr)), bWrite(Other.bWrite) { }
+		FGuard& operator=(FGuard&&) noexcept;
+		~FGuard();
+
+		/** Releases the lock early, if this object owns it. */
+		void Unlock();
+		/** @return true if this object is responsible for releasing a lock. */
+		[[nodiscard]] bool OwnsLock() const noexcept { return Lock != nullptr; }
+		/** @return true if this object owns the lock exclusively. */
+		[[nodiscard]] bool IsWriteLock() const noexcept { return Lock && bWrite; }
+		explicit operator bool() const noexcept { return OwnsLock(); }
+	};
+
+	explicit FAwaitableRWLock(
+		ERWLockPolicy Policy = ERWLockPolicy::PreferWriters) noexcept;
+	UE_NONCOPYABLE(FAwaitableRWLock);
+#if UE5CORO_DEBUG
+	~FAwaitableRWLock();
+#endif
+
+	/** Returns an object that, when co_awaited, locks this object for reading,
+	 *  suspending the coroutine until that's possible. The result of the
+	 *  co_await expression is an FGuard that owns the shared lock. */
+	[[nodiscard]] auto ReadLock() noexcept -> Private::FRWLockAwaiter;
+
+	/** Returns an object that, when co_awaited, locks this object for writing,
+	 *  suspending the coroutine until that's possible. The result of the
+	 *  co_await expression is an FGuard that owns the exclusive lock. */
+	[[nodiscard]] auto WriteLock() noexcept -> Private::FRWLockAwaiter;
+
+	/** Attempts to lock this object for reading without waiting.
+	 *  @return A guard that owns the lock on success, an empty one otherwise. */
+	[[nodiscard]] FGuard TryReadLock() noexcept;
+
+	/** Attempts to lock this object for writing without waiting.
+	 *  @return A guard that owns the lock on success, an empty one otherwise. */
+	[[nodiscard]] FGuard TryWriteLock() noexcept;
+
+private:
+	[[nodiscard]] bool TryReadFast() noexcept;
+	[[nodiscard]] bool TryWriteFast() noexcept;
+	void ReadUnlock();
+	void WriteUnlock();
+	void WakeWaiters();
+};
+
+/** Single-use countdown. co_awaiting this object suspends the coroutine until
+ *  the count reaches zero, after which it never suspends again. */
+class UE5CORO_API FAwaitableLatch final
+{
+	friend Private::FLatchAwaiter;
+	friend Private::Test::FTestHelper;
+
+	std::atomic<int> Count;
+	UE::FMutex Lock;
+	Private::FWaitQueue Waiters;
+
+public:
+	/** Initializes the latch to the given count. */
+	explicit FAwaitableLatch(int Count);
+	UE_NONCOPYABLE(FAwaitableLatch);
+#if UE5CORO_DEBUG
+	~FAwaitableLatch();
+#endif
+
+	/** Decrements the count. If it reaches zero, every coroutine awaiting this
+	 *  latch is resumed on this thread. */
+	void CountDown(int InCount = 1);
+
+	/** @return true if the count has reached zero. */
+	[[nodiscard]] bool TryWait() const noexcept;
+
+	/** Counts down, then returns an object that co_awaits this latch. */
+	[[nodiscard]] auto ArriveAndWait(int InCount = 1) -> Private::FLatchAwaiter;
+
+	auto operator co_await() -> Private::FLatchAwaiter;
+};
+
+/** Reusable barrier for a group of participants that work in phases.
+ *  A phase completes when every participant has arrived: the optional
+ *  completion callback is called on the thread of the last arrival, then every
+ *  coroutine waiting for the phase is resumed, and the next phase begins. */
+class UE5CORO_API FAwaitableBarrier final
+{
+	friend Private::FBarrierAwaiter;
+	friend Private::Test::FTestHelper;
+
+	// The current phase in the upper half, the arrivals it's still waiting for
+	// in the lower half
+	std::atomic<uint64> State;
+	UE::FMutex Lock;
+	int NumParticipants;
+	std::function<void()> OnPhaseCompleted;
+	Private::FWaitQueue Waiters;
+
+public:
+	/** Initializes the barrier for the given number of participants, with an
+	 *  optional callback that's called when each phase completes. */
+	explicit FAwaitableBarrier(int NumParticipants,
+	                           std::function<void()> OnPhaseCompleted = nullptr);
+	UE_NONCOPYABLE(FAwaitableBarrier);
+#if UE5CORO_DEBUG
+	~FAwaitableBarrier();
+#endif
+
+	/** Returns an object that, when co_awaited, arrives at the barrier and
+	 *  suspends the coroutine until the current phase completes.
+	 *  The last participant to arrive does not suspend. */
+	[[nodiscard]] auto ArriveAndWait() -> Private::FBarrierAwaiter;
+
+	/** Arrives at the barrier without waiting for the phase to complete. */
+	void Arrive();
+
+	/** Arrives at the barrier without waiting, and removes one participant
+	 *  from every subsequent phase. */
+	void ArriveAndDrop();
+
+	/** @return The number of phases that have completed so far, modulo 2^32. */
+	[[nodiscard]] uint32 GetPhase() const noexcept;
+
+private:
+	[[nodiscard]] bool ArriveCore(uint32& Phase);
+};
+
+/** Owns a dynamic set of child coroutines. Children leave the group on their
+ *  own when they complete, and every child that's still running is canceled
+ *  when the group is canceled or destroyed.
+ *  Membership is stored in the children themselves, a coroutine can be in at
+ *  most one group at a time. */
+class UE5CORO_API FCoroutineGroup final
+{
+	Private::FCoroutineGroupState* State;
+
+public:
+	FCoroutineGroup();
+	UE_NONCOPYABLE(FCoroutineGroup);
+	/** Cancels every child that's still running. */
+	~FCoroutineGroup();
+
+	/** Adds the coroutine to this group, and returns it for convenience.
+	 *  Completed coroutines are ignored. If the group has been canceled, the
+	 *  coroutine is canceled immediately. */
+	template<typename T>
+	TCoroutine<T> Spawn(TCoroutine<T> Coroutine)
+	{
+		Add(Coroutine);
+		return Coroutine;
+	}
+
+	/** Returns an object that, when co_awaited, suspends the coroutine until
+	 *  every child of this group has completed.
+	 *  It does not suspend if the group is empty.
+	 *  Children of the group must not Join it. */
+	[[nodiscard]] auto Join() -> Private::FGroupJoinAwaiter;
+
+	/** Cancels every child that's currently in the group, and every coroutine
+	 *  that's spawned into it later. */
+	void Cancel();
+
+	/** @return The number of children that have not completed yet. */
+	[[nodiscard]] int Num() const noexcept;
+
+private:
+	void Add(const TCoroutine<>&);
+};
 }
 
 #pragma region Private
 namespace UE5Coro::Private
 {
+struct FLockWaitNode final : FWaitNode
+{
+	// Written by the thread that resumes the awaiter, cleared by await_resume
+	bool bAcquired = false;
+};
+
 class [[nodiscard]] UE5CORO_API FEventAwaiter final
 	: public TCancelableAwaiter<FEventAwaiter>
 {
 	FAwaitableEvent& Event;
+	FWaitNode Node;
 
 public:
 	explicit FEventAwaiter(FAwaitableEvent& Event)
@@ -131,6 +438,7 @@ class [[nodiscard]] UE5CORO_API FSemaphoreAwaiter final
 	: public TCancelableAwaiter<FSemaphoreAwaiter>
 {
 	FAwaitableSemaphore& Semaphore;
+	FWaitNode Node;
 
 public:
 	explicit FSemaphoreAwaiter(FAwaitableSemaphore& Semaphore)
@@ -140,6 +448,100 @@ public:
 	void Suspend(FPromise&);
 	void await_resume() noexcept { }
 
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FMutexLockAwaiter final
+	: public TCancelableAwaiter<FMutexLockAwaiter>
+{
+	FAwaitableMutex& Mutex;
+	FLockWaitNode Node;
+
+public:
+	explicit FMutexLockAwaiter(FAwaitableMutex& Mutex)
+		: TCancelableAwaiter(&Cancel), Mutex(Mutex) { }
+	~FMutexLockAwaiter();
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	[[nodiscard]] FAwaitableMutex::FGuard await_resume() noexcept;
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FRWLockAwaiter final
+	: public TCancelableAwaiter<FRWLockAwaiter>
+{
+	FAwaitableRWLock& Lock;
+	FLockWaitNode Node;
+	bool bWrite;
+
+public:
+	explicit FRWLockAwaiter(FAwaitableRWLock& Lock, bool bWrite)
+		: TCancelableAwaiter(&Cancel), Lock(Lock), bWrite(bWrite) { }
+	~FRWLockAwaiter();
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	[[nodiscard]] FAwaitableRWLock::FGuard await_resume() noexcept;
+
+private:
+	[[nodiscard]] FWaitQueue& GetQueue() const noexcept;
+	static void Cancel(void*, FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FLatchAwaiter final
+	: public TCancelableAwaiter<FLatchAwaiter>
+{
+	FAwaitableLatch& Latch;
+	FWaitNode Node;
+
+public:
+	explicit FLatchAwaiter(FAwaitableLatch& Latch)
+		: TCancelableAwaiter(&Cancel), Latch(Latch) { }
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	void await_resume() noexcept { }
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FBarrierAwaiter final
+	: public TCancelableAwaiter<FBarrierAwaiter>
+{
+	FAwaitableBarrier& Barrier;
+	FWaitNode Node;
+
+public:
+	explicit FBarrierAwaiter(FAwaitableBarrier& Barrier)
+		: TCancelableAwaiter(&Cancel), Barrier(Barrier) { }
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	void await_resume() noexcept { }
+
+private:
+	static void Cancel(void*, FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FGroupJoinAwaiter final
+	: public TCancelableAwaiter<FGroupJoinAwaiter>
+{
+	FCoroutineGroupState& State;
+	FWaitNode Node;
+
+public:
+	explicit FGroupJoinAwaiter(FCoroutineGroupState& State)
+		: TCancelableAwaiter(&Cancel), State(State) { }
+
+	[[nodiscard]] bool await_ready();
+	void Suspend(FPromise&);
+	void await_resume() noexcept { }
+
 private:
 	static void Cancel(void*, FPromise&);
 };
@@ -340,6 +340,184 @@ void DoTest(FAutomationTestBase& Test)
 		}
 	}
 
+	if constexpr (!bLatent)
+	{
+		int State = 0;
+		World.Run(CORO
+		{
+			// Mixed coroutine and non-coroutine parameters
+			auto A = World.Run(CORO
+			{
+				co_await Ticks(2);
+			});
+			int First = co_await WhenAny(A, NextTick(),
+			                             TCoroutine<>::CompletedCoroutine);
+			Test.TestEqual("Completed coroutine first", First, 2);
+			++State;
+			First = co_await WhenAny(NextTick(), A);
+			Test.TestEqual("Awaiter first", First, 0);
+			++State;
+			co_await WhenAll(A, NextTick());
+			++State;
+		});
+		Test.TestEqual("Synchronous completion", State, 1);
+		World.EndTick();
+		World.Tick();
+		Test.TestEqual("Awaiter completed", State, 2);
+		World.Tick();
+		Test.TestEqual("Coroutine completed", State, 3);
+	}
+
+	if constexpr (!bLatent)
+	{
+		int State = 0;
+		World.Run(CORO
+		{
+			auto A = World.Run(CORO_R(int)
+			{
+				co_await NextTick();
+				co_return 1;
+			});
+			auto B = World.Run(CORO_R(FString)
+			{
+				co_await Ticks(2);
+				co_return TEXT("B");
+			});
+			auto C = TCoroutine<int>::FromResult(3);
+			++State;
+			TTuple<int, FString, int> Results =
+				co_await WhenAllResults(A, B, C);
+			Test.TestEqual("First result", Results.Get<0>(), 1);
+			Test.TestEqual("Second result", Results.Get<1>(), TEXT("B"));
+			Test.TestEqual("Third result", Results.Get<2>(), 3);
+			++State;
+		});
+		World.EndTick();
+		Test.TestEqual("Initial state", State, 1);
+		World.Tick();
+		Test.TestEqual("One done", State, 1);
+		World.Tick();
+		Test.TestEqual("Typed results", State, 2);
+	}
+
+	if constexpr (!bLatent)
+	{
+		int State = 0;
+		World.Run(CORO
+		{
+			TArray<TCoroutine<int>> Coroutines;
+			for (int i = 0; i < 3; ++i)
+				Coroutines.Add(World.Run(CORO_R(int)
+				{
+					int Value = i * 10; // Read i before it changes
+					co_await Ticks(3 - Value / 10);
+					co_return Value;
+				}));
+			TArray<int> Results =
+				co_await WhenAllResults(std::move(Coroutines));
+			Test.TestTrue("Results in order", Results == TArray{0, 10, 20});
+			++State;
+		});
+		World.EndTick();
+		for (int i = 0; i < 3; ++i)
+			World.Tick();
+		Test.TestEqual("Array results", State, 1);
+	}
+
+	if constexpr (!bLatent)
+	{
+		bool bCanceled = true;
+		auto Inner = World.Run(CORO_R(int)
+		{
+			co_await Ticks(10);
+			co_return 1;
+		});
+		auto Coro = World.Run(CORO
+		{
+			std::ignore = co_await WhenAllResults(Inner);
+			bCanceled = false;
+		});
+		World.EndTick();
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Canceled", bCanceled);
+		Test.TestFalse("Inner not canceled", Inner.IsDone());
+		FTestHelper::PumpGameThread(World, [&] { return Inner.IsDone(); });
+		Test.TestEqual("Inner result", Inner.GetResult(), 1);
+	}
+
+	if constexpr (!bLatent)
+	{
+		int State = 0;
+		FAwaitableEvent Event;
+		auto Coro = World.Run(CORO_R(int)
+		{
+			++State;
+			int First = co_await WhenAny(Async::PlatformSeconds(0.01), Event);
+			++State;
+			co_return First;
+		});
+		Test.TestEqual("Timer pending", State, 1);
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Timer done", State, 2);
+		Test.TestEqual("Timer first", Coro.GetResult(), 0);
+		Event.Trigger(); // Still being waited for
+	}
+
+	if constexpr (!bLatent)
+	{
+		int State = 0;
+		FAwaitableEvent Event;
+		World.Run(CORO
+		{
+			++State;
+			int First = co_await WhenAny(Async::PlatformSeconds(100), Event);
+			Test.TestEqual("Event first", First, 1);
+			++State;
+		});
+		Test.TestEqual("Event pending", State, 1);
+		Event.Trigger();
+		Test.TestEqual("Resumed by Trigger", State, 2);
+	}
+
+	if constexpr (!bLatent)
+	{
+		int State = 0;
+		FAwaitableSemaphore Semaphore(1, 0);
+		auto Coro = World.Run(CORO
+		{
+			co_await WhenAny(Semaphore, Async::PlatformSeconds(100));
+			++State;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Canceled", State, 0);
+		Semaphore.Unlock();
+		World.Run(CORO
+		{
+			co_await Semaphore; // The canceled aggregate didn't take this
+			++State;
+		});
+		Test.TestEqual("Count available", State, 1);
+		Semaphore.Unlock();
+	}
+
+	{
+		auto A = TCoroutine<int>::FromResult(1);
+		auto B = World.Run(CORO_R(int)
+		{
+			co_await NextTick();
+			co_return 2;
+		});
+		auto Coro = World.Run(CORO
+		{
+			co_await WhenAll(A, B, A);
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("WhenAll keeps results 1", A.GetResult(), 1);
+		Test.TestEqual("WhenAll keeps results 2", B.GetResult(), 2);
+	}
+
 	{
 		bool bCanceled = false;
 		auto Coro = World.Run(CORO
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TestWorld.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro.h"
 
@@ -53,9 +54,38 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncStressTest, "UE5Coro.Async.Stress",
                                  EAutomationTestFlags::MediumPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncTimerWheelTest,
+                                 "UE5Coro.Async.TimerWheel",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncTimerBenchmark,
+                                 "UE5Coro.Async.TimerBenchmark",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
 namespace
 {
 template<typename... T>
+TArray<double> MeasureLateness(int Count, double Interval)
+{
+	TArray<double> Lateness;
+	auto Fn = [&]() -> TCoroutine<>
+	{
+		for (int i = 0; i < Count; ++i)
+		{
+			auto Target = FPlatformTime::Seconds() + Interval;
+			co_await UntilPlatformTimeAnyThread(Target);
+			Lateness.Add(FPlatformTime::Seconds() - Target);
+		}
+	};
+	Fn().Wait();
+	Lateness.Sort();
+	return Lateness;
+}
+
 void DoTest(FAutomationTestBase& Test)
 {
 	FTestWorld World;
@@ -151,6 +181,50 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestTrue("Moved back in", bMovedIn);
 	}
 
+	{
+		std::atomic<uint32> FirstThread = 0, SecondThread = 0;
+		std::atomic<int> Done = 0;
+		World.Run(CORO
+		{
+			co_await MoveToBlockingPool();
+			FirstThread = FPlatformTLS::GetCurrentThreadId();
+			++Done;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Done == 1; });
+		FPlatformProcess::Sleep(0.01f); // Let the thread become idle
+		World.Run(CORO
+		{
+			co_await MoveToBlockingPool();
+			SecondThread = FPlatformTLS::GetCurrentThreadId();
+			++Done;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Done == 2; });
+		Test.TestNotEqual("Off the game thread", FirstThread.load(),
+		                  FPlatformTLS::GetCurrentThreadId());
+		Test.TestEqual("Thread reused", FirstThread.load(), SecondThread.load());
+	}
+
+	{
+		auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+			TEXT("UE5Coro.BlockingPool.MaxThreads"));
+		int32 OldMax = CVar->GetInt();
+		CVar->Set(1);
+		FEventRef TestToCoro;
+		std::atomic<int> State = 0;
+		for (int i = 0; i < 2; ++i)
+			World.Run(CORO
+			{
+				co_await MoveToBlockingPool();
+				if (++State == 1)
+					TestToCoro->Wait();
+			});
+		FPlatformProcess::Sleep(0.01f);
+		Test.TestEqual("Second coroutine queued", State.load(), 1);
+		TestToCoro->Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return State == 2; });
+		CVar->Set(OldMax);
+	}
+
 	{
 		std::atomic<int> State = 0;
 		World.Run(CORO
@@ -172,6 +246,81 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestEqual("Final state", State, 2);
 	}
 
+	{
+		// Timers on different timing wheel levels, and one far in the future
+		std::atomic<int> Count = 0;
+		std::atomic<bool> bEarly = false, bCanceledResumed = false;
+		for (double Seconds : {0.001, 0.03, 0.1, 0.3})
+			World.Run(CORO
+			{
+				auto Target = FPlatformTime::Seconds() + Seconds;
+				co_await UntilPlatformTimeAnyThread(Target);
+				if (FPlatformTime::Seconds() < Target)
+					bEarly = true;
+				++Count;
+			});
+		auto Coro = World.Run(CORO
+		{
+			co_await PlatformSecondsAnyThread(100000);
+			bCanceledResumed = true;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestFalse("Canceled timer not resumed normally", bCanceledResumed);
+		FTestHelper::PumpGameThread(World, [&] { return Count == 4; });
+		Test.TestFalse("No early resume", bEarly);
+	}
+
+	{
+		int State = 0;
+		World.Run(CORO
+		{
+			State = 1;
+			co_await NextFrame();
+			State = 2;
+			co_await Frames(3);
+			State = 3;
+			co_await Frames(0);
+			State = 4;
+		});
+		Test.TestEqual("Initial state", State, 1);
+		World.Tick();
+		Test.TestEqual("Next frame", State, 2);
+		World.Tick();
+		World.Tick();
+		Test.TestEqual("Not yet", State, 2);
+		World.Tick();
+		Test.TestEqual("Three frames", State, 4);
+	}
+
+	{
+		std::atomic<bool> bDone = false, bOnGameThread = false;
+		World.Run(CORO
+		{
+			co_await MoveToTask();
+			co_await NextFrame();
+			bOnGameThread = IsInGameThread();
+			bDone = true;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+		Test.TestTrue("Resumed on the game thread", bOnGameThread);
+	}
+
+	{
+		bool bDone = false, bWrong = false;
+		auto Coro = World.Run(CORO
+		{
+			ON_SCOPE_EXIT { bDone = true; };
+			co_await Frames(1000);
+			bWrong = true;
+		});
+		World.Tick();
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return bDone; });
+		Test.TestFalse("Canceled", bWrong);
+		Test.TestFalse("Unsuccessful", Coro.WasSuccessful());
+	}
+
 	{
 		std::atomic<bool> bDone = false;
 		FEventRef CoroToTest;
@@ -184,6 +333,27 @@ void DoTest(FAutomationTestBase& Test)
 		CoroToTest->Wait();
 		Test.TestTrue("Move successful", bDone);
 	}
+
+	for (float Budget : {0.0f, 0.001f})
+	{
+		auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+			TEXT("UE5Coro.GameThreadInboxBudget"));
+		float OldBudget = CVar->GetFloat();
+		CVar->Set(Budget);
+		int Count = 0;
+		std::atomic<bool> bAllOnGameThread = true;
+		for (int i = 0; i < 1000; ++i)
+			World.Run(CORO
+			{
+				co_await MoveToTask();
+				co_await MoveToGameThread();
+				bAllOnGameThread = bAllOnGameThread && IsInGameThread();
+				++Count;
+			});
+		FTestHelper::PumpGameThread(World, [&] { return Count == 1000; });
+		Test.TestTrue("Resumed on the game thread", bAllOnGameThread.load());
+		CVar->Set(OldBudget);
+	}
 }
 }
 
@@ -234,3 +404,78 @@ bool FAsyncStressTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+bool FAsyncTimerWheelTest::RunTest(const FString& Parameters)
+{
+	// Levels have 64 slots of 1, 64, 4096, and 262144 ticks each, everything
+	// 2^24 or more ticks away is in the overflow bucket
+	const TArray<uint64> Offsets = {
+		3, 63, // Level 0
+		64, 4095, // Level 1
+		4096, 4097, 8191, 200000, // Level 2
+		262144, 262145, 5000000, 16777215, // Level 3
+		16777216, 16777217, 40000000, (1ull << 30) + 5, // Overflow
+	};
+	auto* Wheel = FTestHelper::CreateTimerWheel();
+	TArray<TUniquePtr<FAsyncTimeAwaiter>> Awaiters;
+	for (int i = 0; i < Offsets.Num(); ++i)
+		Awaiters.Add(MakeUnique<FAsyncTimeAwaiter>(0, true));
+	auto AddTimers = [&](uint64 Base)
+	{
+		// Reverse order, so that bucket order doesn't match expiry order
+		for (int i = Offsets.Num() - 1; i >= 0; --i)
+			FTestHelper::AddTimer(*Wheel, *Awaiters[i], Base + Offsets[i]);
+	};
+
+	// Expire everything at once, cascading from every level on the way
+	AddTimers(0);
+	auto Expired = FTestHelper::AdvanceTimerWheel(*Wheel, Offsets.Last());
+	TArray<FAsyncTimeAwaiter*> Expected;
+	for (auto& Awaiter : Awaiters)
+		Expected.Add(Awaiter.Get());
+	TestTrue("Expired in order", Expired == Expected);
+
+	// Step to every timer from an unaligned base, none of them may be early
+	// or late after they were cascaded
+	auto Base = Offsets.Last() + 12345;
+	FTestHelper::AdvanceTimerWheel(*Wheel, Base);
+	AddTimers(Base);
+	for (int i = 0; i < Offsets.Num(); ++i)
+	{
+		auto Tick = Base + Offsets[i];
+		TestEqual("Not early",
+		          FTestHelper::AdvanceTimerWheel(*Wheel, Tick - 1).Num(), 0);
+		Expired = FTestHelper::AdvanceTimerWheel(*Wheel, Tick);
+		TestTrue("Expired on time",
+		         Expired.Num() == 1 && Expired[0] == Awaiters[i].Get());
+	}
+	TestEqual("Nothing left",
+	          FTestHelper::AdvanceTimerWheel(*Wheel, MAX_uint32).Num(), 0);
+
+	FTestHelper::DestroyTimerWheel(Wheel);
+	return true;
+}
+
+bool FAsyncTimerBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 500;
+	constexpr double Interval = 0.002;
+
+	auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+		TEXT("UE5Coro.TimerSpinMargin"));
+	float OldMargin = CVar->GetFloat();
+	for (float Margin : {0.0f, 2.0f})
+	{
+		CVar->Set(Margin);
+		auto Lateness = MeasureLateness(Count, Interval);
+		auto Percentile = [&](int P) { return Lateness[Count * P / 100] * 1e6; };
+		AddInfo(FString::Printf(
+			TEXT("Spin margin %.1f ms: p50 %.0f us, p90 %.0f us, p99 %.0f us, "
+			     "max %.0f us"), Margin, Percentile(50), Percentile(90),
+			Percentile(99), Lateness.Last() * 1e6));
+		TestTrue("Never early", Lateness[0] >= 0);
+	}
+	CVar->Set(OldMargin);
+
+	return true;
+}
@@ -0,0 +1,213 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncGeneratorAsyncTest, "UE5Coro.AsyncGenerator.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncGeneratorLatentTest, "UE5Coro.AsyncGenerator.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TAsyncGenerator<int> CountUp(int Max, int* Produced)
+{
+	for (int i = 1; i <= Max; ++i)
+	{
+		++*Produced;
+		co_yield i;
+	}
+}
+
+TAsyncGenerator<int> YieldOnEvent(FAwaitableEvent* Event, int Count)
+{
+	for (int i = 1; i <= Count; ++i)
+	{
+		co_await *Event;
+		co_yield i;
+	}
+}
+
+TAsyncGenerator<int> YieldOnWorker(int Count)
+{
+	co_await Async::MoveToTask();
+	for (int i = 1; i <= Count; ++i)
+		co_yield i;
+}
+
+TAsyncGenerator<FString> YieldUntilDestroyed(bool* bDestroyed)
+{
+	ON_SCOPE_EXIT { *bDestroyed = true; };
+	for (;;)
+		co_yield TEXT("Value");
+}
+
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int Produced = 0, Sum = 0;
+		auto Generator = CountUp(3, &Produced);
+		Test.TestEqual("Lazy start", Produced, 0);
+		World.Run(CORO
+		{
+			while (auto Value = co_await Generator.Next())
+				Sum += *Value;
+		});
+		Test.TestEqual("Produced", Produced, 3);
+		Test.TestEqual("Sum", Sum, 6);
+		Test.TestTrue("Done", Generator.GetCoroutine().IsDone());
+		Test.TestTrue("Successful", Generator.GetCoroutine().WasSuccessful());
+	}
+
+	{
+		int Produced = 0;
+		TOptional<int> Last;
+		auto Generator = CountUp(10, &Produced);
+		World.Run(CORO
+		{
+			Last = co_await Generator.Next();
+			Test.TestEqual("One value requested", Produced, 1);
+			Last = co_await Generator.Next();
+		});
+		Test.TestEqual("Two values produced", Produced, 2);
+		Test.TestEqual("Last value", Last.Get(0), 2);
+
+		Generator.SetReadAhead(3);
+		Test.TestEqual("Read ahead", Produced, 5);
+		World.Run(CORO
+		{
+			Last = co_await Generator.Next();
+		});
+		Test.TestEqual("Refilled", Produced, 6);
+		Test.TestEqual("Buffered value", Last.Get(0), 3);
+	}
+
+	{
+		FAwaitableEvent Event(EEventMode::AutoReset);
+		TArray<int> Values;
+		bool bEnded = false;
+		auto Generator = YieldOnEvent(&Event, 2);
+		World.Run(CORO
+		{
+			while (auto Value = co_await Generator.Next())
+				Values.Add(*Value);
+			bEnded = true;
+		});
+		Test.TestEqual("Waiting", Values.Num(), 0);
+		Event.Trigger();
+		Test.TestEqual("First value", Values.Num(), 1);
+		Event.Trigger();
+		Test.TestEqual("Second value", Values.Num(), 2);
+		Test.TestTrue("Ended", bEnded);
+	}
+
+	for (int ReadAhead : {0, 1, 8})
+	{
+		constexpr int Count = 1000;
+		int Sum = 0;
+		auto Generator = YieldOnWorker(Count);
+		Generator.SetReadAhead(ReadAhead);
+		auto Coro = World.Run(CORO
+		{
+			while (auto Value = co_await Generator.Next())
+				Sum += *Value;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Pipelined sum", Sum, Count * (Count + 1) / 2);
+	}
+
+	{
+		bool bDestroyed = false;
+		TCoroutine<> Producer = TCoroutine<>::CompletedCoroutine;
+		{
+			auto Generator = YieldUntilDestroyed(&bDestroyed);
+			Producer = Generator.GetCoroutine();
+			World.Run(CORO
+			{
+				auto Value = co_await Generator.Next();
+				Test.TestEqual("Value", Value.Get(TEXT("")), TEXT("Value"));
+			});
+		}
+		FTestHelper::PumpGameThread(World, [&] { return Producer.IsDone(); });
+		Test.TestTrue("Producer destroyed", bDestroyed);
+		Test.TestFalse("Producer canceled", Producer.WasSuccessful());
+	}
+
+	{
+		FAwaitableEvent Event;
+		bool bCanceled = true;
+		auto Generator = YieldOnEvent(&Event, 1);
+		auto Coro = World.Run(CORO
+		{
+			co_await Generator.Next();
+			bCanceled = false;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Consumer canceled", bCanceled);
+
+		// The value is not lost
+		Event.Trigger();
+		TOptional<int> Value;
+		World.Run(CORO
+		{
+			Value = co_await Generator.Next();
+		});
+		Test.TestEqual("Value after cancellation", Value.Get(0), 1);
+	}
+}
+}
+
+bool FAsyncGeneratorAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FAsyncGeneratorLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
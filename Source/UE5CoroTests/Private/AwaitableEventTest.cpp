@@ -238,6 +238,25 @@ void DoTest(FAutomationTestBase& Test, EEventMode Mode)
 		Semaphore.Unlock();
 		Test.TestTrue("Done", bDone);
 	}
+
+	{
+		TArray<int> Order;
+		FAwaitableEvent Event(Mode, false);
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 4; ++i)
+			Coros.Add(World.Run(CORO
+			{
+				int Index = i;
+				co_await Event;
+				Order.Add(Index);
+			}));
+		Coros[1].Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coros[1].IsDone(); });
+		for (int i = 0; i < (Mode == EEventMode::AutoReset ? 3 : 1); ++i)
+			Event.Trigger();
+		Test.TestEqual("FIFO order", Order, TArray{0, 2, 3});
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Event));
+	}
 }
 }
 
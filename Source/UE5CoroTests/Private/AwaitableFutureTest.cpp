@@ -0,0 +1,186 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAwaitableFutureAsyncTest,
+                                 "UE5Coro.Threading.Future.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAwaitableFutureLatentTest,
+                                 "UE5Coro.Threading.Future.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		TAwaitablePromise<int> Promise;
+		auto Future = Promise.GetFuture();
+		Test.TestTrue("Valid", Future.IsValid());
+		Test.TestFalse("Not ready", Future.IsReady());
+		Promise.SetValue(1);
+		Test.TestTrue("Ready", Future.IsReady());
+		int Value = 0;
+		World.Run(CORO
+		{
+			Value = co_await Future;
+		});
+		Test.TestEqual("Synchronous value", Value, 1);
+	}
+
+	{
+		TAwaitablePromise<FString> Promise;
+		auto Future = Promise.GetFuture();
+		bool bSame = false;
+		FString Moved;
+		World.Run(CORO
+		{
+			FString& Value1 = co_await Future;
+			FString& Value2 = co_await Future;
+			bSame = &Value1 == &Value2;
+			Moved = co_await std::move(Future);
+		});
+		Test.TestTrue("Suspended", Moved.IsEmpty());
+		Promise.SetValue(TEXT("Hello"));
+		Test.TestTrue("Same value", bSame);
+		Test.TestEqual("Moved value", Moved, TEXT("Hello"));
+		Test.TestFalse("Consumed", Future.IsValid());
+	}
+
+	{
+		TAwaitablePromise<> Promise;
+		auto Future = Promise.GetFuture();
+		bool bDone = false;
+		World.Run(CORO
+		{
+			co_await Future;
+			bDone = true;
+		});
+		Test.TestFalse("Not done yet", bDone);
+		Promise.SetValue();
+		Test.TestTrue("Done", bDone);
+	}
+
+	{
+		std::optional<TAwaitablePromise<int>> Promise(std::in_place);
+		auto Future = Promise->GetFuture();
+		bool bWrong = false;
+		auto Coro = World.Run(CORO
+		{
+			co_await Future;
+			bWrong = true;
+		});
+		Promise.reset();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestFalse("Abandoned", bWrong);
+		Test.TestFalse("Canceled", Coro.WasSuccessful());
+	}
+
+	{
+		std::optional<TAwaitablePromise<int>> Promise(std::in_place);
+		auto Future = Promise->GetFuture();
+		int Value = -1;
+		bool bWrong = false;
+		auto Coro = World.Run(CORO
+		{
+			{
+				FCancellationGuard _;
+				Value = co_await Future;
+			}
+			co_await Latent::NextTick(); // The cancellation is processed here
+			bWrong = true;
+		});
+		Promise.reset();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Default value while held", Value, 0);
+		Test.TestFalse("Canceled after the guard", bWrong);
+		Test.TestFalse("Unsuccessful", Coro.WasSuccessful());
+	}
+
+	{
+		TAwaitablePromise<int> Promise;
+		auto Future = Promise.GetFuture();
+		bool bWrong = false;
+		auto Coro = World.Run(CORO
+		{
+			co_await Future;
+			bWrong = true;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Promise.SetValue(2);
+		Test.TestFalse("Canceled", bWrong);
+		Test.TestFalse("Unsuccessful", Coro.WasSuccessful());
+	}
+
+	{
+		auto Promise = std::make_shared<TAwaitablePromise<int>>();
+		std::atomic<int> Value = 0;
+		auto Coro = World.Run(CORO
+		{
+			auto Future = Promise->GetFuture();
+			UE::Tasks::Launch(UE_SOURCE_LOCATION, [Promise]
+			{
+				Promise->SetValue(3);
+			});
+			Value = co_await std::move(Future);
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Value from another thread", Value.load(), 3);
+	}
+}
+}
+
+bool FAwaitableFutureAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FAwaitableFutureLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
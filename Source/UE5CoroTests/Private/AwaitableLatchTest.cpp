@@ -0,0 +1,288 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatchAsyncTest, "UE5Coro.Threading.Latch.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatchLatentTest, "UE5Coro.Threading.Latch.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBarrierAsyncTest, "UE5Coro.Threading.Barrier.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBarrierLatentTest, "UE5Coro.Threading.Barrier.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoLatchTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int State = 0;
+		FAwaitableLatch Latch(3);
+		for (int i = 0; i < 2; ++i)
+			World.Run(CORO
+			{
+				co_await Latch;
+				++State;
+			});
+		Test.TestEqual("Initial state", State, 0);
+		Test.TestFalse("Not ready", Latch.TryWait());
+		Latch.CountDown();
+		Test.TestEqual("Count 2", State, 0);
+		Latch.CountDown(2);
+		Test.TestEqual("Released", State, 2);
+		Test.TestTrue("Ready", Latch.TryWait());
+		World.Run(CORO
+		{
+			co_await Latch;
+			++State;
+		});
+		Test.TestEqual("No suspension after release", State, 3);
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Latch));
+	}
+
+	{
+		int State = 0;
+		FAwaitableLatch Latch(0);
+		Test.TestTrue("Zero count", Latch.TryWait());
+		World.Run(CORO
+		{
+			co_await Latch;
+			++State;
+		});
+		Test.TestEqual("No suspension", State, 1);
+	}
+
+	{
+		int State = 0;
+		FAwaitableLatch Latch(2);
+		World.Run(CORO
+		{
+			co_await Latch.ArriveAndWait();
+			++State;
+		});
+		Test.TestEqual("Arrived", State, 0);
+		World.Run(CORO
+		{
+			co_await Latch.ArriveAndWait();
+			++State;
+		});
+		Test.TestEqual("Both arrived", State, 2);
+	}
+
+	{
+		bool bCanceled = true;
+		FAwaitableLatch Latch(1);
+		auto Coro = World.Run(CORO
+		{
+			co_await Latch;
+			bCanceled = false;
+		});
+		Test.TestFalse("Suspended", Coro.IsDone());
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Canceled", bCanceled);
+		Test.TestFalse("Not successful", Coro.WasSuccessful());
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Latch));
+		Latch.CountDown();
+	}
+
+	for (int i = 0; i <= 3; ++i)
+	{
+		FAwaitableLatch Latch(1);
+		bool bCountInTask = (i & 1) != 0;
+		bool bAwaitInTask = (i & 2) != 0;
+		auto Coro = World.Run(CORO
+		{
+			if (bAwaitInTask)
+			{
+				co_await Async::MoveToTask();
+				Test.TestFalse("Not game thread", IsInGameThread());
+			}
+			co_await Latch;
+		});
+		FTestHelper::PumpGameThread(World,
+			[&] { return !FTestHelper::IsIdle(Latch) || Coro.IsDone(); });
+
+		World.Run(CORO
+		{
+			if (bCountInTask)
+			{
+				co_await Async::MoveToTask();
+				Test.TestFalse("Not game thread", IsInGameThread());
+			}
+			Latch.CountDown();
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Successful", Coro.WasSuccessful());
+	}
+}
+
+template<typename... T>
+void DoBarrierTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int Completed = 0;
+		TArray<int> Progress;
+		Progress.SetNumZeroed(3);
+		FAwaitableBarrier Barrier(3, [&] { ++Completed; });
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				int Index = i;
+				for (int j = 0; j < 4; ++j)
+				{
+					++Progress[Index];
+					co_await Barrier.ArriveAndWait();
+				}
+			});
+		// The last participant completes every phase synchronously
+		Test.TestEqual("Phases", Completed, 4);
+		Test.TestEqual("Phase number", Barrier.GetPhase(), 4u);
+		for (int i = 0; i < 3; ++i)
+			Test.TestEqual("Progress", Progress[i], 4);
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Barrier));
+	}
+
+	{
+		int State = 0;
+		FAwaitableBarrier Barrier(2);
+		World.Run(CORO
+		{
+			co_await Barrier.ArriveAndWait();
+			++State;
+			co_await Barrier.ArriveAndWait();
+			++State;
+		});
+		Test.TestEqual("Waiting", State, 0);
+		Barrier.Arrive();
+		Test.TestEqual("Phase 1", State, 1);
+		Test.TestEqual("Phase number 1", Barrier.GetPhase(), 1u);
+		Barrier.ArriveAndDrop();
+		Test.TestEqual("Phase 2", State, 2);
+		// Only one participant is left
+		World.Run(CORO
+		{
+			co_await Barrier.ArriveAndWait();
+			++State;
+		});
+		Test.TestEqual("Phase 3", State, 3);
+		Test.TestEqual("Phase number 3", Barrier.GetPhase(), 3u);
+	}
+
+	{
+		bool bCanceled = true;
+		FAwaitableBarrier Barrier(2);
+		auto Coro = World.Run(CORO
+		{
+			co_await Barrier.ArriveAndWait();
+			bCanceled = false;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Canceled", bCanceled);
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Barrier));
+		// The canceled arrival still counts
+		Test.TestEqual("Same phase", Barrier.GetPhase(), 0u);
+		Barrier.Arrive();
+		Test.TestEqual("Next phase", Barrier.GetPhase(), 1u);
+	}
+
+	{
+		constexpr int Count = 8, Phases = 16;
+		std::atomic<int> Done = 0, Sum = 0, Completed = 0;
+		FAwaitableBarrier Barrier(Count, [&] { ++Completed; });
+		for (int i = 0; i < Count; ++i)
+			World.Run(CORO
+			{
+				co_await Async::MoveToTask();
+				for (int j = 0; j < Phases; ++j)
+				{
+					// Nobody can get ahead by more than one phase
+					int Phase = Completed;
+					Test.TestTrue("Lockstep", Phase == j);
+					++Sum;
+					co_await Barrier.ArriveAndWait();
+				}
+				++Done;
+			});
+		FTestHelper::PumpGameThread(World, [&] { return Done == Count; });
+		Test.TestEqual("Sum", Sum.load(), Count * Phases);
+		Test.TestEqual("Completed", Completed.load(), Phases);
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Barrier));
+	}
+}
+}
+
+bool FLatchAsyncTest::RunTest(const FString& Parameters)
+{
+	DoLatchTest<>(*this);
+	return true;
+}
+
+bool FLatchLatentTest::RunTest(const FString& Parameters)
+{
+	DoLatchTest<FLatentActionInfo>(*this);
+	return true;
+}
+
+bool FBarrierAsyncTest::RunTest(const FString& Parameters)
+{
+	DoBarrierTest<>(*this);
+	return true;
+}
+
+bool FBarrierLatentTest::RunTest(const FString& Parameters)
+{
+	DoBarrierTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -0,0 +1,220 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMutexAsyncTest, "UE5Coro.Threading.Mutex.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMutexLatentTest, "UE5Coro.Threading.Mutex.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMutexBenchmark, "UE5Coro.Threading.Mutex.Benchmark",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		FAwaitableMutex Mutex;
+		auto Guard = Mutex.TryLock();
+		Test.TestTrue("Locked", Guard.OwnsLock());
+		Test.TestFalse("Already locked", Mutex.TryLock().OwnsLock());
+		Guard.Unlock();
+		Test.TestFalse("Unlocked", Guard.OwnsLock());
+		Test.TestTrue("Lockable again", Mutex.TryLock().OwnsLock());
+	}
+
+	{
+		TArray<int> Order;
+		FAwaitableMutex Mutex;
+		auto Guard = Mutex.TryLock();
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				int Index = i;
+				auto Lock = co_await Mutex.Lock();
+				Order.Add(Index);
+			});
+		Test.TestEqual("Not resumed yet", Order.Num(), 0);
+		Guard.Unlock(); // Every guard unlocks at the end of its coroutine
+		Test.TestEqual("FIFO order", Order, TArray{0, 1, 2});
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Mutex));
+		Test.TestTrue("Unlocked", Mutex.TryLock().OwnsLock());
+	}
+
+	{
+		int State = 0;
+		FAwaitableMutex Mutex;
+		auto Guard = Mutex.TryLock();
+		auto First = World.Run(CORO
+		{
+			auto Lock = co_await Mutex.Lock();
+			State = 1;
+			auto Lock2 = co_await Mutex.Lock(); // Deadlock until canceled
+			State = 2;
+		});
+		auto Second = World.Run(CORO
+		{
+			auto Lock = co_await Mutex.Lock();
+			State = 3;
+		});
+		auto Third = World.Run(CORO
+		{
+			auto Lock = co_await Mutex.Lock();
+			State = 4;
+		});
+		Third.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Third.IsDone(); });
+		Guard.Unlock();
+		Test.TestEqual("First coroutine holds the lock", State, 1);
+		Second.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Second.IsDone(); });
+		Test.TestEqual("Second coroutine never ran", State, 1);
+		Test.TestFalse("Still locked", Mutex.TryLock().OwnsLock());
+		First.Cancel(); // Its first guard unlocks the mutex
+		FTestHelper::PumpGameThread(World, [&] { return First.IsDone(); });
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Mutex));
+		Test.TestTrue("Unlocked by cancellation", Mutex.TryLock().OwnsLock());
+	}
+
+	IF_CORO_ASYNC
+	{
+		// Race cancellations against Unlock() handing the mutex over
+		for (int i = 0; i < 200; ++i)
+		{
+			FAwaitableMutex Mutex;
+			auto Guard = Mutex.TryLock();
+			auto Waiter = World.Run(CORO
+			{
+				auto Lock = co_await Mutex.Lock();
+			});
+			std::atomic<bool> bGo = false;
+			auto Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [&]
+			{
+				while (!bGo) { } // Line up with Unlock() as much as possible
+				Waiter.Cancel();
+			});
+			bGo = true;
+			Guard.Unlock();
+			Task.Wait();
+			FTestHelper::PumpGameThread(World, [&] { return Waiter.IsDone(); });
+			if (!Mutex.TryLock().OwnsLock())
+			{
+				Test.AddError(TEXT("Canceled handoff left the mutex locked"));
+				break;
+			}
+		}
+	}
+}
+
+template<typename F>
+double RunBenchmark(F Fn, int NumCoroutines, int Iterations)
+{
+	std::atomic<int> Done = 0;
+	auto Start = FPlatformTime::Seconds();
+	for (int i = 0; i < NumCoroutines; ++i)
+		Fn(Iterations, Done);
+	while (Done != NumCoroutines)
+		FPlatformProcess::Yield();
+	auto Total = FPlatformTime::Seconds() - Start;
+	return Total / (NumCoroutines * Iterations) * 1e9;
+}
+}
+
+bool FMutexAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FMutexLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
+
+bool FMutexBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Iterations = 10000;
+	FAwaitableMutex Mutex;
+	FAwaitableSemaphore Semaphore;
+	int Counter = 0;
+
+	auto UseMutex = [&](int Count, std::atomic<int>& Done) -> TCoroutine<>
+	{
+		co_await Async::MoveToTask();
+		for (int i = 0; i < Count; ++i)
+		{
+			auto Lock = co_await Mutex.Lock();
+			++Counter;
+		}
+		++Done;
+	};
+	auto UseSemaphore = [&](int Count, std::atomic<int>& Done) -> TCoroutine<>
+	{
+		co_await Async::MoveToTask();
+		for (int i = 0; i < Count; ++i)
+		{
+			co_await Semaphore;
+			++Counter;
+			Semaphore.Unlock();
+		}
+		++Done;
+	};
+
+	for (int NumCoroutines : {1, 8})
+	{
+		double MutexTime = RunBenchmark(UseMutex, NumCoroutines, Iterations);
+		double SemaphoreTime = RunBenchmark(UseSemaphore, NumCoroutines,
+		                                    Iterations);
+		AddInfo(FString::Printf(
+			TEXT("%d coroutine(s): mutex %.1f ns, semaphore %.1f ns per lock"),
+			NumCoroutines, MutexTime, SemaphoreTime));
+	}
+	TestEqual("Counter", Counter, 2 * 9 * Iterations);
+	return true;
+}
@@ -0,0 +1,198 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRWLockAsyncTest, "UE5Coro.Threading.RWLock.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRWLockLatentTest, "UE5Coro.Threading.RWLock.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		FAwaitableRWLock Lock;
+		auto Read1 = Lock.TryReadLock();
+		auto Read2 = Lock.TryReadLock();
+		Test.TestTrue("Read locked", Read1.OwnsLock() && Read2.OwnsLock());
+		Test.TestFalse("Shared", Read1.IsWriteLock());
+		Test.TestFalse("Not write lockable", Lock.TryWriteLock().OwnsLock());
+		Read1.Unlock();
+		Read2.Unlock();
+		auto Write = Lock.TryWriteLock();
+		Test.TestTrue("Write locked", Write.IsWriteLock());
+		Test.TestFalse("Not read lockable", Lock.TryReadLock().OwnsLock());
+		Test.TestFalse("Exclusive", Lock.TryWriteLock().OwnsLock());
+		Write.Unlock();
+		Test.TestTrue("Unlocked", Lock.TryWriteLock().OwnsLock());
+	}
+
+	for (auto Policy : {ERWLockPolicy::PreferWriters,
+	                    ERWLockPolicy::PreferReaders})
+	{
+		bool bPreferWriters = Policy == ERWLockPolicy::PreferWriters;
+		TArray<int> Order;
+		FAwaitableRWLock Lock(Policy);
+		auto Read = Lock.TryReadLock();
+		World.Run(CORO
+		{
+			auto Guard = co_await Lock.WriteLock();
+			Order.Add(1);
+		});
+		World.Run(CORO
+		{
+			auto Guard = co_await Lock.ReadLock();
+			Order.Add(2);
+		});
+		if (bPreferWriters)
+		{
+			Test.TestEqual("Reader waits behind the writer", Order.Num(), 0);
+			Test.TestFalse("Not read lockable", Lock.TryReadLock().OwnsLock());
+		}
+		else
+			Test.TestEqual("Reader joined", Order, TArray{2});
+		Read.Unlock();
+		Test.TestEqual("Order", Order,
+		               bPreferWriters ? TArray{1, 2} : TArray{2, 1});
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Lock));
+		Test.TestTrue("Unlocked", Lock.TryWriteLock().OwnsLock());
+	}
+
+	{
+		int Readers = 0;
+		int MaxReaders = 0;
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		FAwaitableRWLock Lock;
+		auto Write = Lock.TryWriteLock();
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				auto Guard = co_await Lock.ReadLock();
+				MaxReaders = FMath::Max(MaxReaders, ++Readers);
+				co_await Event;
+				--Readers;
+			});
+		Test.TestEqual("Waiting", Readers, 0);
+		Write.Unlock();
+		Test.TestEqual("Every reader woke up", MaxReaders, 3);
+		Test.TestFalse("Read locked", Lock.TryWriteLock().OwnsLock());
+		Event.Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return Readers == 0; });
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Lock));
+		Test.TestTrue("Unlocked", Lock.TryWriteLock().OwnsLock());
+	}
+
+	{
+		int State = 0;
+		FAwaitableRWLock Lock;
+		auto Write = Lock.TryWriteLock();
+		auto Reader = World.Run(CORO
+		{
+			auto Guard = co_await Lock.ReadLock();
+			State = 1;
+		});
+		auto Writer = World.Run(CORO
+		{
+			auto Guard = co_await Lock.WriteLock();
+			State = 2;
+		});
+		Reader.Cancel();
+		Writer.Cancel();
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Reader.IsDone() && Writer.IsDone();
+		});
+		Write.Unlock();
+		Test.TestEqual("Canceled coroutines never ran", State, 0);
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Lock));
+		Test.TestTrue("Unlocked", Lock.TryWriteLock().OwnsLock());
+	}
+
+	IF_CORO_ASYNC
+	{
+		// Race cancellations against unlocking granting the lock to readers
+		// and writers
+		for (int i = 0; i < 200; ++i)
+		{
+			bool bWrite = i % 2 == 0;
+			FAwaitableRWLock Lock;
+			auto Write = Lock.TryWriteLock();
+			auto Waiter = World.Run(CORO
+			{
+				auto Guard = co_await (bWrite ? Lock.WriteLock()
+				                              : Lock.ReadLock());
+			});
+			std::atomic<bool> bGo = false;
+			auto Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [&]
+			{
+				while (!bGo) { } // Line up with Unlock() as much as possible
+				Waiter.Cancel();
+			});
+			bGo = true;
+			Write.Unlock();
+			Task.Wait();
+			FTestHelper::PumpGameThread(World, [&] { return Waiter.IsDone(); });
+			if (!Lock.TryWriteLock().OwnsLock())
+			{
+				Test.AddError(TEXT("Canceled grant left the lock locked"));
+				break;
+			}
+		}
+	}
+}
+}
+
+bool FRWLockAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FRWLockLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -46,6 +46,11 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSemaLatentTest, "UE5Coro.Threading.Semaphore.L
                                  EAutomationTestFlags::CriticalPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSemaBenchmark, "UE5Coro.Threading.Semaphore.Benchmark",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
 namespace
 {
 template<typename... T>
@@ -163,6 +168,58 @@ void DoTest(FAutomationTestBase& Test)
 		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
 		Test.TestTrue("Successful", Coro.WasSuccessful());
 	}
+
+	for (auto Flags : {ESemaphoreFlags::None, ESemaphoreFlags::Handoff})
+	{
+		int A = 0, B = 0;
+		FAwaitableSemaphore Semaphore(2, 0, Flags);
+		World.Run(CORO
+		{
+			co_await Semaphore;
+			++A;
+			co_await Semaphore; // Barges in front of B without handoff
+			++A;
+		});
+		World.Run(CORO
+		{
+			co_await Semaphore;
+			++B;
+		});
+		Semaphore.Unlock(2);
+		if (Flags == ESemaphoreFlags::Handoff)
+		{
+			Test.TestEqual("First awaiter", A, 1);
+			Test.TestEqual("Second awaiter got its count", B, 1);
+		}
+		else
+		{
+			Test.TestEqual("First awaiter", A, 2);
+			Test.TestEqual("Second awaiter starved", B, 0);
+		}
+		Semaphore.Unlock();
+		Test.TestEqual("Final A", A, 2);
+		Test.TestEqual("Final B", B, 1);
+	}
+
+	for (auto Flags : {ESemaphoreFlags::DispatchWakes,
+	                   ESemaphoreFlags::Handoff | ESemaphoreFlags::DispatchWakes})
+	{
+		constexpr int Count = 8;
+		std::atomic<int> Done = 0, OnGameThread = 0;
+		FAwaitableSemaphore Semaphore(Count, 0, Flags);
+		for (int i = 0; i < Count; ++i)
+			World.Run(CORO
+			{
+				co_await Semaphore;
+				if (IsInGameThread())
+					++OnGameThread;
+				++Done;
+			});
+		Semaphore.Unlock(Count);
+		Test.TestTrue("All taken by Unlock", FTestHelper::IsIdle(Semaphore));
+		FTestHelper::PumpGameThread(World, [&] { return Done == Count; });
+		Test.TestEqual("Dispatched to workers", OnGameThread.load(), 0);
+	}
 }
 }
 
@@ -177,3 +234,46 @@ bool FSemaLatentTest::RunTest(const FString& Parameters)
 	DoTest<FLatentActionInfo>(*this);
 	return true;
 }
+
+bool FSemaBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 10000;
+	FTestWorld World;
+	FAwaitableSemaphore Semaphore(Count, 0);
+	int Resumed = 0;
+	auto Fn = [&]() -> TCoroutine<>
+	{
+		co_await Semaphore;
+		++Resumed;
+	};
+
+	TArray<TCoroutine<>> Coros;
+	Coros.Reserve(Count);
+	auto Start = FPlatformTime::Seconds();
+	for (int i = 0; i < Count; ++i)
+		Coros.Add(Fn());
+	auto Suspended = FPlatformTime::Seconds();
+	// Cancel every other awaiter, this used to search the list for each
+	for (int i = 0; i < Count; i += 2)
+		Coros[i].Cancel();
+	auto Canceled = FPlatformTime::Seconds();
+	Semaphore.Unlock(Count / 2);
+	auto Unlocked = FPlatformTime::Seconds();
+
+	FTestHelper::PumpGameThread(World, [&]
+	{
+		for (auto& Coro : Coros)
+			if (!Coro.IsDone())
+				return false;
+		return true;
+	});
+	TestEqual("Resumed", Resumed, Count / 2);
+	TestTrue("Idle", FTestHelper::IsIdle(Semaphore));
+	AddInfo(FString::Printf(
+		TEXT("%d awaiters: %.1f ns per suspend, %.1f ns per cancel, "
+		     "%.1f ns per resume"), Count,
+		(Suspended - Start) / Count * 1e9,
+		(Canceled - Suspended) / (Count / 2) * 1e9,
+		(Unlocked - Canceled) / (Count / 2) * 1e9));
+	return true;
+}
@@ -0,0 +1,179 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBroadcastChannelAsyncTest, "UE5Coro.Threading.BroadcastChannel.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBroadcastChannelLatentTest, "UE5Coro.Threading.BroadcastChannel.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TOptional<int> Get(const TSharedPtr<const int>& Value)
+{
+	return Value ? TOptional<int>(*Value) : TOptional<int>();
+}
+
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		TArray<int> Values1, Values2;
+		TBroadcastChannel<int> Channel(4);
+		auto Subscriber1 = Channel.Subscribe();
+		auto Subscriber2 = Channel.Subscribe();
+		for (auto* Values : {&Values1, &Values2})
+			World.Run(CORO
+			{
+				auto* MyValues = Values;
+				auto& Subscriber = MyValues == &Values1 ? Subscriber1
+				                                        : Subscriber2;
+				while (auto Value = co_await Subscriber.Next())
+					MyValues->Add(*Value);
+			});
+		Test.TestTrue("Publish 1", Channel.TryPublish(1));
+		Test.TestTrue("Publish 2", Channel.TryPublish(2));
+		Test.TestEqual("Every value 1", Values1, TArray{1, 2});
+		Test.TestEqual("Every value 2", Values2, TArray{1, 2});
+		Channel.Close();
+		Test.TestFalse("Closed", Channel.TryPublish(3));
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+	}
+
+	{
+		TBroadcastChannel<TArray<int>> Channel(2);
+		auto Subscriber1 = Channel.Subscribe();
+		auto Subscriber2 = Channel.Subscribe();
+		Test.TestTrue("Publish", Channel.TryPublish(TArray{1, 2, 3}));
+		auto Value1 = Subscriber1.TryNext();
+		auto Value2 = Subscriber2.TryNext();
+		if (Test.TestTrue("Received", Value1 && Value2))
+		{
+			Test.TestEqual("Value", *Value1, TArray{1, 2, 3});
+			Test.TestEqual("Shared, not copied", Value1.Get(), Value2.Get());
+		}
+	}
+
+	{
+		TBroadcastChannel<int> Channel(2);
+		auto Early = Channel.Subscribe();
+		Test.TestTrue("Publish 1", Channel.TryPublish(1));
+		auto Late = Channel.Subscribe();
+		for (int i = 2; i <= 4; ++i)
+			Test.TestTrue("Publish", Channel.TryPublish(i));
+		Test.TestEqual("Oldest available", Get(Early.TryNext()), TOptional(3));
+		Test.TestEqual("Dropped", Early.GetNumDropped(), 2ull);
+		Test.TestEqual("Late subscriber", Get(Late.TryNext()), TOptional(3));
+		Test.TestEqual("Dropped late", Late.GetNumDropped(), 1ull);
+
+		bool bDone = false;
+		World.Run(CORO
+		{
+			auto Value = co_await Early.Next();
+			Test.TestEqual("Available without waiting", Get(Value),
+			               TOptional(4));
+			bDone = true;
+		});
+		Test.TestTrue("Done", bDone);
+	}
+
+	{
+		TArray<bool> Results;
+		TBroadcastChannel<int> Channel(1, EBroadcastOverflow::BlockPublisher);
+		Test.TestTrue("No subscribers", Channel.TryPublish(0));
+		auto Subscriber = Channel.Subscribe();
+		Test.TestTrue("Publish 1", Channel.TryPublish(1));
+		Test.TestFalse("Full", Channel.TryPublish(2));
+		for (int i = 2; i <= 3; ++i)
+			World.Run(CORO
+			{
+				int Value = i;
+				Results.Add(co_await Channel.Publish(Value));
+			});
+		Test.TestEqual("Blocked", Results.Num(), 0);
+		Test.TestEqual("Receive 1", Get(Subscriber.TryNext()), TOptional(1));
+		Test.TestEqual("One publisher resumed", Results, TArray{true});
+		Test.TestEqual("Receive 2", Get(Subscriber.TryNext()), TOptional(2));
+		Test.TestEqual("Both publishers resumed", Results, TArray{true, true});
+		Test.TestEqual("No drops", Subscriber.GetNumDropped(), 0ull);
+
+		World.Run(CORO { Results.Add(co_await Channel.Publish(4)); });
+		Channel.Close();
+		Test.TestEqual("Pending publish failed", Results,
+		               TArray{true, true, false});
+		Test.TestEqual("Drain", Get(Subscriber.TryNext()), TOptional(3));
+		Test.TestFalse("Drained", Subscriber.TryNext().IsValid());
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+	}
+
+	{
+		bool bReceived = false;
+		TBroadcastChannel<int> Channel(1);
+		auto Subscriber = Channel.Subscribe();
+		auto Coro = World.Run(CORO
+		{
+			co_await Subscriber.Next();
+			bReceived = true;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+		Test.TestTrue("Publish", Channel.TryPublish(1));
+		Test.TestFalse("Canceled subscriber did not run", bReceived);
+		Test.TestEqual("Value kept", Get(Subscriber.TryNext()), TOptional(1));
+	}
+}
+}
+
+bool FBroadcastChannelAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FBroadcastChannelLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -0,0 +1,173 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCancellationSourceAsyncTest,
+                                 "UE5Coro.Cancel.Source.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCancellationSourceLatentTest,
+                                 "UE5Coro.Cancel.Source.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		FCancellationToken Token;
+		Test.TestFalse("Default token", Token.IsCancellationRequested());
+		FCancellationSource Source;
+		Token = Source.GetToken();
+		Test.TestFalse("Not canceled", Token.IsCancellationRequested());
+		Source.Cancel();
+		Test.TestTrue("Source canceled", Source.IsCancellationRequested());
+		Test.TestTrue("Token canceled", Token.IsCancellationRequested());
+	}
+
+	{
+		std::atomic<int> NumCanceled = 0;
+		FCancellationSource Source;
+		TArray<TCoroutine<>> Coroutines;
+		for (int i = 0; i < 50; ++i)
+			Coroutines.Add(World.Run(CORO
+			{
+				FOnCoroutineCanceled _([&] { ++NumCanceled; });
+				co_await LinkCancellation(Source.GetToken());
+				co_await Latent::Ticks(1000);
+			}));
+		for (int i = 0; i < 50; ++i)
+		{
+			auto Coro = World.Run(CORO
+			{
+				FOnCoroutineCanceled _([&] { ++NumCanceled; });
+				co_await Latent::Ticks(1000);
+			});
+			LinkCancellation(Source.GetToken(), Coro);
+			Coroutines.Add(Coro);
+		}
+		World.Tick();
+		Test.TestEqual("Not canceled yet", NumCanceled.load(), 0);
+		Source.Cancel();
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Coroutines.FindByPredicate([](auto& Coro)
+			{
+				return !Coro.IsDone();
+			}) == nullptr;
+		});
+		Test.TestEqual("Every coroutine canceled", NumCanceled.load(), 100);
+	}
+
+	{
+		int State = 0;
+		FCancellationSource Source;
+		auto Coro = World.Run(CORO
+		{
+			co_await LinkCancellation(Source.GetToken());
+			++State;
+		});
+		Test.TestTrue("Completed", Coro.WasSuccessful());
+		Source.Cancel();
+		Test.TestEqual("Completed coroutines are unlinked", State, 1);
+	}
+
+	{
+		int State = 0;
+		FCancellationSource Source1, Source2;
+		FAwaitableEvent Event;
+		auto Coro = World.Run(CORO
+		{
+			co_await LinkCancellation(Source1.GetToken());
+			co_await LinkCancellation(Source2.GetToken());
+			co_await LinkCancellation({});
+			co_await Event;
+			++State;
+		});
+		Source1.Cancel();
+		Source2.Cancel();
+		Event.Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Unlinked", Coro.WasSuccessful());
+		Test.TestEqual("Resumed", State, 1);
+	}
+
+	{
+		int State = 0;
+		FCancellationSource Source;
+		Source.Cancel();
+		auto Coro1 = World.Run(CORO
+		{
+			co_await LinkCancellation(Source.GetToken());
+			++State;
+		});
+		auto Coro2 = World.Run(CORO
+		{
+			co_await Latent::Ticks(1000);
+			++State;
+		});
+		LinkCancellation(Source.GetToken(), Coro2);
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Coro1.IsDone() && Coro2.IsDone();
+		});
+		Test.TestFalse("Canceled on link", Coro1.WasSuccessful());
+		Test.TestFalse("Canceled on external link", Coro2.WasSuccessful());
+		Test.TestEqual("Not resumed", State, 0);
+	}
+}
+}
+
+bool FCancellationSourceAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest(*this);
+	return true;
+}
+
+bool FCancellationSourceLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
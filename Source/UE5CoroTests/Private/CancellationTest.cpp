@@ -184,13 +184,57 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestFalse("Not done yet", Coro.IsDone());
 		Test.TestFalse("Still running", Coro.WasSuccessful());
 		Coro.Cancel();
-		Test.TestFalse("Not destroyed yet", bDestroyed);
-		World.Tick(); // This processes the cancellation
+		IF_CORO_LATENT
+			// Latent cancellations are expedited on the game thread
+			Test.TestTrue("Destroyed immediately", bDestroyed);
+		else
+		{
+			Test.TestFalse("Not destroyed yet", bDestroyed);
+			World.Tick(); // This processes the cancellation
+		}
 		Test.TestTrue("Canceled", bCanceled);
 		Test.TestTrue("Canceled", bDestroyed);
 		Test.TestFalse("Not successful", Coro.WasSuccessful());
 	}
 
+	IF_CORO_LATENT
+	{
+		constexpr int Count = 5000;
+		int Destroyed = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < Count; ++i)
+			Coros.Add(World.Run(CORO
+			{
+				ON_SCOPE_EXIT { ++Destroyed; };
+				co_await Ticks(1000);
+			}));
+		World.EndTick();
+		Test.TestEqual("All active", Destroyed, 0);
+		for (auto& Coro : Coros)
+			Coro.Cancel();
+		Test.TestEqual("All destroyed immediately", Destroyed, Count);
+
+		Coros.Reset();
+		Destroyed = 0;
+		for (int i = 0; i < Count; ++i)
+			Coros.Add(World.Run(CORO
+			{
+				ON_SCOPE_EXIT { ++Destroyed; };
+				co_await Ticks(1000);
+			}));
+		World.EndTick();
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [&]
+		{
+			for (auto& Coro : Coros)
+				Coro.Cancel();
+		}).Wait();
+		Test.TestEqual("Cancellations are queued", Destroyed, 0);
+		World.Tick(); // This processes the queue
+		Test.TestEqual("All destroyed in one tick", Destroyed, Count);
+		for (auto& Coro : Coros)
+			Test.TestFalse("Not successful", Coro.WasSuccessful());
+	}
+
 	{
 		std::atomic<bool> bDone = false;
 		auto Coro = World.Run(CORO
@@ -0,0 +1,233 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelAsyncTest, "UE5Coro.Threading.Channel.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelLatentTest, "UE5Coro.Threading.Channel.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelBenchmark, "UE5Coro.Threading.Channel.Benchmark",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		TChannel<int> Channel(2);
+		Test.TestTrue("Send 1", Channel.TrySend(1));
+		Test.TestTrue("Send 2", Channel.TrySend(2));
+		Test.TestFalse("Full", Channel.TrySend(3));
+		Test.TestEqual("Receive 1", Channel.TryReceive(), TOptional(1));
+		Test.TestTrue("Send 3", Channel.TrySend(3));
+		Test.TestEqual("Receive 2", Channel.TryReceive(), TOptional(2));
+		Test.TestEqual("Receive 3", Channel.TryReceive(), TOptional(3));
+		Test.TestFalse("Empty", Channel.TryReceive().IsSet());
+	}
+
+	{
+		TArray<int> Values;
+		TChannel<int> Channel(1);
+		World.Run(CORO
+		{
+			while (auto Value = co_await Channel.Receive())
+				Values.Add(*Value);
+		});
+		Test.TestEqual("Waiting", Values.Num(), 0);
+		Test.TestTrue("Send 1", Channel.TrySend(1));
+		Test.TestTrue("Send 2", Channel.TrySend(2));
+		Test.TestEqual("Received", Values, TArray{1, 2});
+		Channel.Close();
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+	}
+
+	{
+		TArray<bool> Results;
+		TChannel<int> Channel(1);
+		Test.TestTrue("Send 1", Channel.TrySend(1));
+		for (int i = 2; i <= 3; ++i)
+			World.Run(CORO
+			{
+				int Value = i;
+				Results.Add(co_await Channel.Send(Value));
+			});
+		Test.TestEqual("Backpressure", Results.Num(), 0);
+		Test.TestEqual("Receive 1", Channel.TryReceive(), TOptional(1));
+		Test.TestEqual("One sender resumed", Results, TArray{true});
+		Test.TestEqual("Receive 2", Channel.TryReceive(), TOptional(2));
+		Test.TestEqual("FIFO", Channel.TryReceive(), TOptional(3));
+		Test.TestEqual("Both senders resumed", Results, TArray{true, true});
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+	}
+
+	{
+		int Values[] = {1, 2, 3};
+		TChannel<int> Channel(2);
+		Test.TestEqual("Partial batch", Channel.TrySendMany(Values), 2);
+		bool bDone = false;
+		World.Run(CORO
+		{
+			auto Batch = co_await Channel.ReceiveMany(5);
+			Test.TestEqual("Batch", Batch, TArray{1, 2});
+			bDone = true;
+		});
+		Test.TestTrue("Received without waiting", bDone);
+	}
+
+	{
+		TArray<int> Values;
+		TOptional<bool> Sent;
+		TChannel<int> Channel(2);
+		Test.TestTrue("Send 1", Channel.TrySend(1));
+		Test.TestTrue("Send 2", Channel.TrySend(2));
+		World.Run(CORO { Sent = co_await Channel.Send(3); });
+		Channel.Close();
+		Test.TestEqual("Pending send failed", Sent, TOptional(false));
+		Test.TestTrue("Closed", Channel.IsClosed());
+		Test.TestFalse("Closed to senders", Channel.TrySend(4));
+		World.Run(CORO
+		{
+			for (;;)
+			{
+				auto Batch = co_await Channel.ReceiveMany(10);
+				if (Batch.IsEmpty())
+					break;
+				Values.Append(Batch);
+			}
+			Values.Add(-1);
+		});
+		Test.TestEqual("Drained", Values, TArray{1, 2, -1});
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+	}
+
+	{
+		bool bReceived = false;
+		TChannel<int> Channel(1);
+		auto Coro = World.Run(CORO
+		{
+			co_await Channel.Receive();
+			bReceived = true;
+		});
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Idle", FTestHelper::IsIdle(Channel));
+		Test.TestTrue("Send", Channel.TrySend(1));
+		Test.TestFalse("Canceled receiver did not run", bReceived);
+		Test.TestEqual("Value kept", Channel.TryReceive(), TOptional(1));
+	}
+}
+
+double RunBenchmark(FAutomationTestBase& Test, int NumSenders,
+                    int NumReceivers, int NumValues)
+{
+	TChannel<int> Channel(64);
+	std::atomic<int> SendersLeft = NumSenders;
+	std::atomic<int> Running = NumSenders + NumReceivers;
+	std::atomic<int64> Sum = 0;
+
+	auto Sender = [&](int Count) -> TCoroutine<>
+	{
+		co_await Async::MoveToTask();
+		for (int i = 1; i <= Count; ++i)
+			co_await Channel.Send(i);
+		if (--SendersLeft == 0)
+			Channel.Close();
+		--Running;
+	};
+	auto Receiver = [&]() -> TCoroutine<>
+	{
+		co_await Async::MoveToTask();
+		int64 LocalSum = 0;
+		while (auto Value = co_await Channel.Receive())
+			LocalSum += *Value;
+		Sum += LocalSum;
+		--Running;
+	};
+
+	int PerSender = NumValues / NumSenders;
+	auto Start = FPlatformTime::Seconds();
+	for (int i = 0; i < NumReceivers; ++i)
+		Receiver();
+	for (int i = 0; i < NumSenders; ++i)
+		Sender(PerSender);
+	while (Running != 0)
+		FPlatformProcess::Yield();
+	auto Total = FPlatformTime::Seconds() - Start;
+
+	int64 Expected = static_cast<int64>(PerSender) * (PerSender + 1) / 2;
+	Test.TestEqual("Every value received once", Sum.load(),
+	               Expected * NumSenders);
+	return Total / (NumSenders * PerSender) * 1e9;
+}
+}
+
+bool FChannelAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FChannelLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
+
+bool FChannelBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int NumValues = 100000;
+	for (auto [NumSenders, NumReceivers] : {std::pair(1, 1), std::pair(4, 1),
+	                                        std::pair(4, 4)})
+	{
+		double Time = RunBenchmark(*this, NumSenders, NumReceivers,
+		                           NumValues);
+		AddInfo(FString::Printf(TEXT("%d:%d coroutines: %.1f ns per value"),
+		                        NumSenders, NumReceivers, Time));
+	}
+	return true;
+}
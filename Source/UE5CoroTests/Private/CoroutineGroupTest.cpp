@@ -0,0 +1,158 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineGroupAsyncTest,
+                                 "UE5Coro.Threading.CoroutineGroup.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineGroupLatentTest,
+                                 "UE5Coro.Threading.CoroutineGroup.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int State = 0;
+		FCoroutineGroup Group;
+		World.Run(CORO
+		{
+			co_await Group.Join();
+			++State;
+		});
+		Test.TestEqual("Empty group does not suspend", State, 1);
+		Group.Spawn(TCoroutine<>::CompletedCoroutine);
+		Test.TestEqual("Completed coroutines are ignored", Group.Num(), 0);
+	}
+
+	{
+		int State = 0;
+		FCoroutineGroup Group;
+		FAwaitableEvent Event1, Event2;
+		auto Child1 = Group.Spawn(World.Run(CORO
+		{
+			co_await Event1;
+		}));
+		Group.Spawn(World.Run(CORO
+		{
+			co_await Event2;
+		}));
+		Test.TestEqual("Two children", Group.Num(), 2);
+		World.Run(CORO
+		{
+			co_await Group.Join();
+			++State;
+		});
+		Event1.Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return Child1.IsDone(); });
+		Test.TestEqual("One child left", Group.Num(), 1);
+		Test.TestEqual("Still joining", State, 0);
+		Event2.Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return State == 1; });
+		Test.TestEqual("Empty", Group.Num(), 0);
+	}
+
+	{
+		std::atomic<int> NumCanceled = 0;
+		TArray<TCoroutine<>> Children;
+		{
+			FCoroutineGroup Group;
+			for (int i = 0; i < 100; ++i)
+				Children.Add(Group.Spawn(World.Run(CORO
+				{
+					FOnCoroutineCanceled _([&] { ++NumCanceled; });
+					co_await Latent::Ticks(1000);
+				})));
+			Test.TestEqual("Spawned", Group.Num(), 100);
+		}
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Children.FindByPredicate([](auto& Child)
+			{
+				return !Child.IsDone();
+			}) == nullptr;
+		});
+		Test.TestEqual("Destruction canceled every child", NumCanceled.load(), 100);
+	}
+
+	{
+		int State = 0;
+		FCoroutineGroup Group;
+		auto Child = Group.Spawn(World.Run(CORO
+		{
+			co_await Latent::Ticks(1000);
+		}));
+		World.Run(CORO
+		{
+			co_await Group.Join();
+			++State;
+		});
+		Group.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return State == 1; });
+		Test.TestFalse("Canceled child", Child.WasSuccessful());
+		auto Late = Group.Spawn(World.Run(CORO
+		{
+			co_await Latent::Ticks(1000);
+		}));
+		FTestHelper::PumpGameThread(World, [&] { return Late.IsDone(); });
+		Test.TestFalse("Spawning into a canceled group cancels",
+		               Late.WasSuccessful());
+	}
+}
+}
+
+bool FCoroutineGroupAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest(*this);
+	return true;
+}
+
+bool FCoroutineGroupLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -0,0 +1,197 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Latent;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentCoroutineLocalTest,
+                                 "UE5Coro.CoroutineLocal.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncCoroutineLocalTest,
+                                 "UE5Coro.CoroutineLocal.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+int GLiveCounters = 0;
+
+struct FLiveCounter
+{
+	int Value = 0;
+	FLiveCounter() { ++GLiveCounters; }
+	~FLiveCounter() { --GLiveCounters; }
+	UE_NONCOPYABLE(FLiveCounter);
+};
+
+TCoroutineLocal<int> GInt;
+TCoroutineLocal<FLiveCounter> GCounter;
+TCoroutineLocal<double> GDouble;
+TCoroutineLocal<FString> GString;
+
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		auto Coro = World.Run(CORO
+		{
+			Test.TestNull("Not constructed yet", GInt.TryGet());
+			Test.TestEqual("Value initialized", *GInt, 0);
+			Test.TestNotNull("Constructed", GInt.TryGet());
+			*GInt = 1;
+			co_await NextTick();
+			Test.TestEqual("Value kept", *GInt, 1);
+			GInt.Reset();
+			Test.TestNull("Reset", GInt.TryGet());
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Done", Coro.WasSuccessful());
+	}
+
+	{
+		int Values[2] = {0, 0};
+		auto Coro1 = World.Run(CORO
+		{
+			GInt.Get() = 10;
+			GCounter->Value = 0;
+			co_await NextTick();
+			Values[0] = *GInt + GCounter->Value;
+		});
+		auto Coro2 = World.Run(CORO
+		{
+			GInt.Get() = 11;
+			GCounter->Value = 1;
+			co_await NextTick();
+			Values[1] = *GInt + GCounter->Value;
+		});
+		Test.TestEqual("Two counters", GLiveCounters, 2);
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Coro1.IsDone() && Coro2.IsDone();
+		});
+		Test.TestEqual("Separate values 1", Values[0], 10);
+		Test.TestEqual("Separate values 2", Values[1], 12);
+		Test.TestEqual("Counters destroyed", GLiveCounters, 0);
+	}
+
+	{
+		std::atomic<bool> bSame = false;
+		auto Coro = World.Run(CORO
+		{
+			auto* Address = &GCounter.Get();
+			Address->Value = 5;
+			co_await Async::MoveToTask();
+			bSame = &GCounter.Get() == Address && GCounter->Value == 5;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Value followed the coroutine", bSame.load());
+		Test.TestEqual("Counter destroyed", GLiveCounters, 0);
+	}
+
+	{
+		auto Coro = World.Run(CORO
+		{
+			auto& Int = GInt.Get();
+			Int = 7;
+			*GDouble = 1.0;
+			*GString = TEXT("Test");
+			GCounter->Value = 2;
+			Test.TestTrue("Stable reference", &Int == &GInt.Get());
+			GDouble.Reset();
+			Test.TestEqual("Value kept", *GInt, 7);
+			Test.TestEqual("Other value kept", *GString, TEXT("Test"));
+			co_await NextTick();
+			Test.TestNull("Still reset", GDouble.TryGet());
+			Test.TestEqual("Counter value kept", GCounter->Value, 2);
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Done", Coro.WasSuccessful());
+		Test.TestEqual("Counter destroyed", GLiveCounters, 0);
+	}
+
+	{
+		auto Coro = World.Run(CORO
+		{
+			auto& Int = GInt.Get();
+			Int = 8;
+			// Registered after this coroutine allocated its storage
+			static TCoroutineLocal<FLiveCounter> LateCounter;
+			Test.TestNull("Late local not constructed", LateCounter.TryGet());
+			LateCounter->Value = 3;
+			co_await NextTick();
+			Test.TestTrue("Stable reference", &Int == &GInt.Get());
+			Test.TestEqual("Value kept", *GInt, 8);
+			Test.TestEqual("Late value kept", LateCounter->Value, 3);
+			LateCounter.Reset();
+			Test.TestEqual("Late counter reset", GLiveCounters, 0);
+			LateCounter.Get();
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Done", Coro.WasSuccessful());
+		Test.TestEqual("Late counter destroyed", GLiveCounters, 0);
+	}
+
+	{
+		auto Coro = World.Run(CORO
+		{
+			GCounter.Get();
+			co_await Ticks(1000);
+		});
+		Test.TestEqual("Counter alive", GLiveCounters, 1);
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Destroyed on cancellation", GLiveCounters, 0);
+	}
+}
+}
+
+bool FAsyncCoroutineLocalTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FLatentCoroutineLocalTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -0,0 +1,145 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Async;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineExecutorTest,
+                                 "UE5Coro.Async.Executor",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineExecutorBenchmark,
+                                 "UE5Coro.Async.ExecutorBenchmark",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+TCoroutine<> Hop(auto Awaiter, int Count, std::atomic<int>& Counter)
+{
+	// Start off the game thread, Yield() would otherwise keep using it
+	co_await MoveToTask();
+	for (int i = 0; i < Count; ++i)
+	{
+		co_await Awaiter;
+		++Counter;
+	}
+}
+
+double RunBenchmark(auto Awaiter, int NumCoroutines, int Hops)
+{
+	std::atomic<int> Counter = 0;
+	TArray<TCoroutine<>> Coros;
+	double Start = FPlatformTime::Seconds();
+	for (int i = 0; i < NumCoroutines; ++i)
+		Coros.Add(Hop(Awaiter, Hops, Counter));
+	for (auto& Coro : Coros)
+		Coro.Wait();
+	double Elapsed = FPlatformTime::Seconds() - Start;
+	check(Counter == NumCoroutines * Hops);
+	return Elapsed * 1e9 / (NumCoroutines * Hops);
+}
+}
+
+bool FCoroutineExecutorTest::RunTest(const FString& Parameters)
+{
+	{
+		FCoroutineExecutor Executor(2);
+		TestEqual("Workers", Executor.GetNumWorkers(), 2);
+		std::atomic<bool> bOnWorker = false;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await MoveToExecutor(Executor);
+			bOnWorker = !IsInGameThread();
+		}();
+		Coro.Wait();
+		TestTrue("Moved to worker", bOnWorker.load());
+	}
+
+	{
+		FCoroutineExecutor Executor(4);
+		std::atomic<int> Counter = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 100; ++i)
+			Coros.Add(Hop(MoveToExecutor(Executor), 100, Counter));
+		for (auto& Coro : Coros)
+			TestTrue("Completed", Coro.Wait(10000));
+		TestEqual("Every hop ran", Counter.load(), 10000);
+	}
+
+	{
+		std::atomic<int> Counter = 0;
+		auto Coro = Hop(MoveToExecutor(), 10, Counter);
+		TestTrue("Default executor", Coro.Wait(10000));
+		TestEqual("Every hop ran", Counter.load(), 10);
+	}
+
+	{
+		FCoroutineExecutor Executor(1);
+		bool bCanceled = true;
+		FEventRef Event;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await MoveToExecutor(Executor);
+			Event->Wait();
+			co_await MoveToExecutor(Executor);
+			bCanceled = false;
+		}();
+		Coro.Cancel();
+		Event->Trigger();
+		Coro.Wait();
+		TestTrue("Canceled on the executor", bCanceled);
+		TestFalse("Unsuccessful", Coro.WasSuccessful());
+	}
+
+	return true;
+}
+
+bool FCoroutineExecutorBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int NumCoroutines = 64;
+	constexpr int Hops = 10000;
+
+	// Yield() from a worker thread resumes on AnyThread through the task graph,
+	// which is what MoveToThread(AnyThread) does when it needs to suspend
+	double TaskGraph = RunBenchmark(Yield(), NumCoroutines, Hops);
+	double Executor = RunBenchmark(MoveToExecutor(), NumCoroutines, Hops);
+
+	AddInfo(FString::Printf(TEXT("Task graph: %.1f ns per resume"), TaskGraph));
+	AddInfo(FString::Printf(TEXT("Executor: %.1f ns per resume"), Executor));
+	return true;
+}
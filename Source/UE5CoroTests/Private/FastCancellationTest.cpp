@@ -313,7 +313,11 @@ void DoTest(FAutomationTestBase& Test)
 		World.EndTick();
 		CoroToTest->Wait();
 		Coro2.Cancel();
-		Test.TestFalse("Cancellation not processed yet", bCanceled);
+		// Race cancels Coro1, which is expedited if it's latent
+		IF_CORO_LATENT
+			Test.TestTrue("Cancellation processed", bCanceled);
+		else
+			Test.TestFalse("Cancellation not processed yet", bCanceled);
 		World.Tick();
 		FTestHelper::PumpGameThread(World, [&] { return bCanceled; });
 		Test.TestFalse("Direct cancel", bWrong);
@@ -0,0 +1,172 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FForEachConcurrentAsyncTest,
+                                 "UE5Coro.Aggregate.ForEachConcurrent.Async",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FForEachConcurrentLatentTest,
+                                 "UE5Coro.Aggregate.ForEachConcurrent.Latent",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int State = 0;
+		World.Run(CORO
+		{
+			auto Failures = co_await Async::ForEachConcurrent(TArray<int>(), 2,
+				[](int) -> TCoroutine<> { co_return; });
+			Test.TestEqual("No failures", Failures.Num(), 0);
+			++State;
+		});
+		Test.TestEqual("Empty range completes synchronously", State, 1);
+	}
+
+	{
+		int State = 0;
+		TArray<int> Seen;
+		World.Run(CORO
+		{
+			auto Failures = co_await Async::ForEachConcurrent(
+				TArray{1, 2, 3}, 1, [&](int i) -> TCoroutine<>
+				{
+					Seen.Add(i);
+					co_return;
+				});
+			Test.TestEqual("No failures", Failures.Num(), 0);
+			++State;
+		});
+		Test.TestEqual("Synchronous coroutines complete", State, 1);
+		Test.TestTrue("Rvalue range visited in order", Seen == TArray{1, 2, 3});
+	}
+
+	{
+		int State = 0;
+		int NumInFlight = 0;
+		int Peak = 0;
+		FAwaitableEvent Events[5];
+		TArray<TCoroutine<>> Started;
+		TArray<int> Failures;
+		auto Body = [&](FAwaitableEvent& Event) -> TCoroutine<>
+		{
+			Peak = FMath::Max(Peak, ++NumInFlight);
+			ON_SCOPE_EXIT { --NumInFlight; };
+			co_await Event;
+		};
+		World.Run(CORO
+		{
+			Failures = co_await Async::ForEachConcurrent(Events, 2,
+				[&](FAwaitableEvent& Event)
+				{
+					auto Coro = Body(Event);
+					Started.Add(Coro);
+					return Coro;
+				});
+			++State;
+		});
+		Test.TestEqual("Limited start", Started.Num(), 2);
+		Events[1].Trigger();
+		Test.TestEqual("Next one started", Started.Num(), 3);
+		Test.TestEqual("Still limited", NumInFlight, 2);
+		Started[0].Cancel(); // This might be processed on another thread
+		FTestHelper::PumpGameThread(World, [&] { return Started.Num() == 4; });
+		Test.TestEqual("Canceled one replaced", Started.Num(), 4);
+		Events[3].Trigger();
+		Events[2].Trigger();
+		Test.TestEqual("All started", Started.Num(), 5);
+		Test.TestEqual("Not done", State, 0);
+		Events[4].Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return State == 1; });
+		Test.TestEqual("Done", State, 1);
+		Test.TestEqual("Peak", Peak, 2);
+		Test.TestTrue("Failures", Failures == TArray{0});
+	}
+
+	{
+		bool bCanceled = true;
+		std::atomic<int> NumCanceled = 0;
+		FAwaitableEvent Events[4];
+		TArray<TCoroutine<>> Started;
+		auto Body = [&](FAwaitableEvent& Event) -> TCoroutine<>
+		{
+			FOnCoroutineCanceled _([&] { ++NumCanceled; });
+			co_await Event;
+		};
+		auto Coro = World.Run(CORO
+		{
+			std::ignore = co_await Async::ForEachConcurrent(Events, 3,
+				[&](FAwaitableEvent& Event)
+				{
+					auto Inner = Body(Event);
+					Started.Add(Inner);
+					return Inner;
+				});
+			bCanceled = false;
+		});
+		Test.TestEqual("Started", Started.Num(), 3);
+		Coro.Cancel();
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestTrue("Canceled", bCanceled);
+		Test.TestEqual("Running ones canceled", NumCanceled.load(), 3);
+		Test.TestEqual("No new ones started", Started.Num(), 3);
+	}
+}
+}
+
+bool FForEachConcurrentAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest(*this);
+	return true;
+}
+
+bool FForEachConcurrentLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -0,0 +1,197 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "UE5CoroTestObject.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Latent;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentAdmissionTest, "UE5Coro.Latent.Admission",
+                                 EAutomationTestFlags_ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLatentAdmissionTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	// World.Run uses the subsystem as the callback target
+	auto* Owner = World->GetSubsystem<UUE5CoroSubsystem>();
+
+	{
+		SetAdmissionLimit(Owner, 2, EAdmissionPolicy::Reject);
+		int Started = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 3; ++i)
+			Coros.Add(World.Run([&](FLatentActionInfo) -> TCoroutine<>
+			{
+				++Started;
+				co_await NextTick();
+			}));
+		TestEqual("Started", Started, 2);
+		TestTrue("Rejected", Coros[2].IsDone());
+		TestFalse("Rejected unsuccessfully", Coros[2].WasSuccessful());
+		auto Counters = GetAdmissionCounters(Owner);
+		TestEqual("Live", Counters.Live, 2);
+		TestEqual("Admitted", Counters.Admitted, 2);
+		TestEqual("Rejected", Counters.Rejected, 1);
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Coros[0].IsDone() && Coros[1].IsDone();
+		});
+		TestTrue("Successful", Coros[0].WasSuccessful());
+		TestEqual("Nothing live", GetAdmissionCounters(Owner).Live, 0);
+		SetAdmissionLimit(Owner, -1, EAdmissionPolicy::Reject);
+	}
+
+	{
+		SetAdmissionLimit(Owner, 1, EAdmissionPolicy::Queue);
+		int Started = 0;
+		auto Coro1 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			++Started;
+			co_await NextTick();
+		});
+		auto Coro2 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			++Started;
+			co_await NextTick();
+		});
+		auto Coro3 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			++Started;
+			co_return;
+		});
+		TestEqual("One started", Started, 1);
+		TestEqual("Two queued", GetAdmissionCounters(Owner).Queued, 2);
+		Coro3.Cancel();
+		World.Tick(); // Coro3 is canceled while queued
+		FTestHelper::PumpGameThread(World, [&] { return Coro2.IsDone(); });
+		TestEqual("Two started", Started, 2);
+		TestTrue("Successful 1", Coro1.WasSuccessful());
+		TestTrue("Successful 2", Coro2.WasSuccessful());
+		TestTrue("Canceled while queued", Coro3.IsDone());
+		TestFalse("Never ran", Coro3.WasSuccessful());
+		auto Counters = GetAdmissionCounters(Owner);
+		TestEqual("Nothing live", Counters.Live, 0);
+		TestEqual("Nothing queued", Counters.Queued, 0);
+		TestEqual("Admitted", Counters.Admitted, 2);
+		SetAdmissionLimit(Owner, -1, EAdmissionPolicy::Queue);
+	}
+
+	{
+		SetAdmissionLimit(Owner, 1, EAdmissionPolicy::Queue);
+		bool bStarted = false;
+		auto Coro1 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			co_await Ticks(1000);
+		});
+		auto Coro2 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			bStarted = true;
+			co_return;
+		});
+		TestFalse("Queued", bStarted);
+		SetAdmissionLimit(Owner, -1, EAdmissionPolicy::Queue);
+		TestTrue("Started by removing the limit", bStarted);
+		TestTrue("Done", Coro2.WasSuccessful());
+		Coro1.Cancel();
+	}
+
+	{
+		SetClassAdmissionLimit(UUE5CoroSubsystem::StaticClass(), 1,
+		                       EAdmissionPolicy::CancelOldest);
+		auto Coro1 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			co_await Ticks(1000);
+		});
+		TestFalse("Running", Coro1.IsDone());
+		auto Coro2 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			co_await Ticks(1000);
+		});
+		// Latent cancellations on the game thread are processed immediately
+		TestTrue("Evicted", Coro1.IsDone());
+		TestFalse("Evicted unsuccessfully", Coro1.WasSuccessful());
+		TestFalse("Running", Coro2.IsDone());
+		auto Counters =
+			GetClassAdmissionCounters(UUE5CoroSubsystem::StaticClass());
+		TestEqual("Live", Counters.Live, 1);
+		TestEqual("Evicted", Counters.Evicted, 1);
+		Coro2.Cancel();
+		TestEqual("Nothing live",
+		          GetClassAdmissionCounters(UUE5CoroSubsystem::StaticClass()).Live,
+		          0);
+		SetClassAdmissionLimit(UUE5CoroSubsystem::StaticClass(), -1,
+		                       EAdmissionPolicy::CancelOldest);
+	}
+
+	{
+		SetAdmissionLimit(Owner, 1, EAdmissionPolicy::Queue);
+		TArray<int> Order;
+		auto Coro1 = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+		{
+			Order.Add(1);
+			co_await NextTick();
+		});
+		TArray<TCoroutine<>> Queued;
+		for (int i = 2; i <= 5; ++i)
+			Queued.Add(World.Run([&, i](FLatentActionInfo) -> TCoroutine<>
+			{
+				Order.Add(i);
+				co_await NextTick();
+			}));
+		Queued[1].Cancel(); // 3 never runs
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Queued.FindByPredicate([](auto& Coro)
+			{
+				return !Coro.IsDone();
+			}) == nullptr;
+		});
+		TestTrue("Queued in order", Order == TArray{1, 2, 4, 5});
+		SetAdmissionLimit(Owner, -1, EAdmissionPolicy::Queue);
+	}
+
+	{
+		auto* Object = NewObject<UUE5CoroTestObject>(World);
+		SetAdmissionLimit(Object, 1, EAdmissionPolicy::Reject);
+		Object->MarkAsGarbage();
+		// This must not ensure
+		SetAdmissionLimit(Object, -1, EAdmissionPolicy::Reject);
+		TestEqual("Removed", GetAdmissionCounters(Object).Admitted, 0);
+	}
+
+	return true;
+}
@@ -69,11 +69,13 @@ void DoTest(FAutomationTestBase& Test)
 		});
 		World.EndTick();
 		Inner->Cancel();
-		Test.TestFalse("Not done yet", Coro.IsDone());
-		Test.TestFalse("Inner not done yet", Inner->IsDone());
-		World.Tick(); // Inner will complete here
+		// Inner is latent and awaiting a latent awaiter, this is expedited
+		Test.TestTrue("Inner done", Inner->IsDone());
 		IF_CORO_LATENT
-			World.Tick(); // Latent-latent might need an extra tick
+		{
+			Test.TestFalse("Not done yet", Coro.IsDone());
+			World.Tick(); // Latent-latent polls the inner coroutine
+		}
 		Test.TestTrue("Cancellation processed", Coro.IsDone());
 	}
 
@@ -84,12 +86,32 @@ void DoTest(FAutomationTestBase& Test)
 		});
 		World.EndTick();
 		Coro.Cancel();
-		// Expedited async cancellation will behave identically to latent
-		// cancellation, because it happens asynchronously on the game thread
-		Test.TestFalse("Not done yet", Coro.IsDone());
-		World.Tick();
+		// Expedited async cancellation happens asynchronously on the game
+		// thread, latent coroutines awaiting latent awaiters are destroyed now
+		IF_CORO_ASYNC
+		{
+			Test.TestFalse("Not done yet", Coro.IsDone());
+			World.Tick();
+		}
 		Test.TestTrue("Done", Coro.IsDone());
 	}
+
+	{
+		auto Coro = World.Run(CORO_R(int)
+		{
+			auto Inner = []() -> TCoroutine<int>
+			{
+				co_await Async::MoveToNewThread();
+				co_return 2;
+			};
+			int A = co_await Inner(); // Move
+			auto Handle = Inner();
+			int B = co_await Handle; // Copy
+			co_return A + B;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual("Result", Coro.GetResult(), 4);
+	}
 }
 }
 
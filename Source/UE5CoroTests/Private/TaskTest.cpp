@@ -109,6 +109,20 @@ void DoCreateTest(FAutomationTestBase& Test)
 		TestToCoro->Trigger();
 		Test.TestTrue("Triggered", CoroToTest->Wait());
 	}
+
+	{
+		FEventRef CoroToTest;
+		std::atomic<bool> bOnGameThread = true;
+		World.Run(CORO
+		{
+			co_await MoveToTask(TEXT("Low"),
+			                    UE::Tasks::ETaskPriority::BackgroundLow);
+			bOnGameThread = IsInGameThread();
+			CoroToTest->Trigger();
+		});
+		Test.TestTrue("Triggered", CoroToTest->Wait());
+		Test.TestFalse("Moved to background task", bOnGameThread.load());
+	}
 }
 
 template<typename... T>
@@ -168,6 +182,28 @@ void DoConsumeTest(FAutomationTestBase& Test)
 		Test.TestEqual("Final state", State, 2);
 		Test.TestEqual("Return value", Retval, 3);
 	}
+
+	{
+		FEventRef TestToCoro, CoroToTest;
+		std::atomic<bool> bOnGameThread = true;
+		int Retval = 0;
+		World.Run(CORO
+		{
+			auto Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [&]
+			{
+				TestToCoro->Wait();
+				return 4;
+			});
+			Retval = co_await AwaitTask(Task,
+			                            UE::Tasks::ETaskPriority::BackgroundLow);
+			bOnGameThread = IsInGameThread();
+			CoroToTest->Trigger();
+		});
+		TestToCoro->Trigger();
+		CoroToTest->Wait();
+		Test.TestFalse("Resumed in a task", bOnGameThread.load());
+		Test.TestEqual("Return value", Retval, 4);
+	}
 }
 }
 
@@ -31,6 +31,7 @@
 
 #include "TestWorld.h"
 #include "HAL/ThreadManager.h"
+#include "TimerThread.h"
 
 using namespace UE5Coro::Private::Test;
 
@@ -103,11 +104,86 @@ int FTestHelper::ReadSemaphore(FAwaitableSemaphore& Semaphore)
 bool FTestHelper::IsIdle(FAwaitableEvent& Event)
 {
 	UE::TUniqueLock Lock(Event.Lock);
-	return Event.AwaitingPromises.empty();
+	return Event.Waiters.IsEmpty();
 }
 
 bool FTestHelper::IsIdle(FAwaitableSemaphore& Semaphore)
 {
 	UE::TUniqueLock Lock(Semaphore.Lock);
-	return Semaphore.AwaitingPromises.empty();
+	return Semaphore.Waiters.IsEmpty();
+}
+
+bool FTestHelper::IsIdle(FAwaitableMutex& Mutex)
+{
+	UE::TUniqueLock Lock(Mutex.QueueLock);
+	return Mutex.Waiters.IsEmpty();
+}
+
+bool FTestHelper::IsIdle(FAwaitableRWLock& RWLock)
+{
+	UE::TUniqueLock Lock(RWLock.QueueLock);
+	return RWLock.ReadWaiters.IsEmpty() && RWLock.WriteWaiters.IsEmpty();
+}
+
+bool FTestHelper::IsIdle(FAwaitableLatch& Latch)
+{
+	UE::TUniqueLock Lock(Latch.Lock);
+	return Latch.Waiters.IsEmpty();
+}
+
+bool FTestHelper::IsIdle(FAwaitableBarrier& Barrier)
+{
+	UE::TUniqueLock Lock(Barrier.Lock);
+	return Barrier.Waiters.IsEmpty();
+}
+
+bool FTestHelper::IsIdle(Private::FChannelBase& Channel)
+{
+	UE::TUniqueLock Lock(Channel.Lock);
+	return Channel.Senders.IsEmpty() && Channel.Receivers.IsEmpty() &&
+	       Channel.NumSenders == 0 && Channel.NumReceivers == 0;
+}
+
+bool FTestHelper::IsIdle(Private::FBroadcastChannelBase& Channel)
+{
+	UE::TUniqueLock Lock(Channel.Lock);
+	return Channel.Readers.IsEmpty() && Channel.Publishers.IsEmpty();
+}
+
+auto FTestHelper::CreateTimerWheel() -> FTimerThread*
+{
+	return new FTimerThread(FTimerThread::FNoThread());
+}
+
+void FTestHelper::DestroyTimerWheel(FTimerThread* Wheel)
+{
+	delete Wheel;
+}
+
+void FTestHelper::AddTimer(FTimerThread& Wheel, FAsyncTimeAwaiter& Awaiter,
+                           uint64 Tick)
+{
+	// Expiring awaiters hand over their promise to be resumed. This one is
+	// only used to identify the awaiter, and it's never resumed.
+	Awaiter.Promise = reinterpret_cast<FPromise*>(&Awaiter);
+	Awaiter.TargetTime = static_cast<double>(Tick) * FTimerThread::Resolution;
+	Awaiter.Tick = Tick;
+	UE::TUniqueLock Lock(Wheel.Lock);
+	Wheel.Link(&Awaiter);
+}
+
+auto FTestHelper::AdvanceTimerWheel(FTimerThread& Wheel, uint64 Tick)
+	-> TArray<FAsyncTimeAwaiter*>
+{
+	TArray<FTimerThread::FExpired> Expired;
+	{
+		UE::TUniqueLock Lock(Wheel.Lock);
+		auto Now = static_cast<double>(Tick) * FTimerThread::Resolution;
+		Wheel.Advance(Tick, Now, Expired);
+		std::ignore = Wheel.ExpireSpinning(Now, Expired);
+	}
+	TArray<FAsyncTimeAwaiter*> Awaiters;
+	for (auto& Entry : Expired)
+		Awaiters.Add(reinterpret_cast<FAsyncTimeAwaiter*>(Entry.Promise));
+	return Awaiters;
 }
@@ -114,5 +114,32 @@ public:
 	static int ReadSemaphore(FAwaitableSemaphore&);
 	static bool IsIdle(FAwaitableEvent&);
 	static bool IsIdle(FAwaitableSemaphore&);
+	static bool IsIdle(FAwaitableMutex&);
+	static bool IsIdle(FAwaitableRWLock&);
+	static bool IsIdle(FAwaitableLatch&);
+	static bool IsIdle(FAwaitableBarrier&);
+	static bool IsIdle(Private::FChannelBase&);
+	static bool IsIdle(Private::FBroadcastChannelBase&);
+
+	// Timer wheels without a thread, time only passes in AdvanceTimerWheel.
+	// Ticks are in the wheel's resolution, starting from 0.
+	static Private::FTimerThread* CreateTimerWheel();
+	static void DestroyTimerWheel(Private::FTimerThread*);
+	static void AddTimer(Private::FTimerThread&, Private::FAsyncTimeAwaiter&,
+	                     uint64 Tick);
+	static TArray<Private::FAsyncTimeAwaiter*> AdvanceTimerWheel(
+		Private::FTimerThread&, uint64 Tick);
+
+	template<typename T>
+	static bool IsIdle(TChannel<T>& Channel)
+	{
+		return IsIdle(static_cast<Private::FChannelBase&>(Channel));
+	}
+
+	template<typename T>
+	static bool IsIdle(TBroadcastChannel<T>& Channel)
+	{
+		return IsIdle(static_cast<Private::FBroadcastChannelBase&>(Channel));
+	}
 };
 }
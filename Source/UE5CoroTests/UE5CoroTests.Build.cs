@@ -29,6 +29,7 @@
 // OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+using System.IO;
 using UnrealBuildTool;
 
 public class UE5CoroTests : UE5CoroModuleRules
@@ -41,5 +42,9 @@ public class UE5CoroTests : UE5CoroModuleRules
 			"HTTP",
 			"UE5Coro",
 		});
+
+		// White-box tests of UE5Coro's internals
+		PrivateIncludePaths.Add(Path.Combine(ModuleDirectory, "..", "UE5Coro",
+		                                     "Private"));
 	}
 }